@@ -0,0 +1,234 @@
+
+// Heap allocations per message where one message is built per batch: a link
+// filling the batch of a depth update (handle_depth), and base_client reading
+// a message off the stream (poll). "before" builds a new message each time, as
+// they used to. "after" is what they do now: the links clear and refill the
+// same batch (link_base::next_batch), base_client parses into a message on
+// its read_arena. A reused message is not enough on the read path: Clear()
+// deletes the compact levels of a proto3 message, so it is shown as well.
+//
+// operator new is counted in this program, so the figures are those of
+// protobuf itself, without the JSON parsing of the links or the gRPC reads.
+// The batch sizes vary from message to message, up to --levels.
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+
+#include "bench_util.h"
+#include "../client/base_client.h"
+#include "../wire_codec.h"
+
+ABSL_FLAG(int, messages, 20000, "Messages per pass");
+ABSL_FLAG(int, levels, 40, "Most levels in a batch");
+ABSL_FLAG(int, coalesced, 8, "Batches in a coalesced message");
+
+namespace {
+
+size_t allocations = 0;
+
+}   // namespace
+
+void* operator new(size_t size) {
+    ++allocations;
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+// the levels of a venue message once parsed, bids then asks
+struct depth_message {
+    int64_t event_time;
+    std::vector<std::pair<double, double>> bids;
+    std::vector<std::pair<double, double>> asks;
+};
+
+std::vector<depth_message> make_messages(std::mt19937& rng, int n, int levels) {
+    std::uniform_int_distribution<int> size(1, levels);
+    std::uniform_int_distribution<int> offset(1, 200);
+    std::uniform_real_distribution<double> qty(0, 5);
+    std::vector<depth_message> messages(n);
+    for (int m = 0; m < n; ++m) {
+        auto& message = messages[m];
+        message.event_time = 1'700'000'000'000 + m;
+        int count = size(rng);
+        for (int i = 0; i < count; ++i) {
+            auto& side = i % 2 == 0 ? message.bids : message.asks;
+            side.emplace_back(i % 2 == 0 ? 100000 - offset(rng) * 0.01 : 100000 + offset(rng) * 0.01, qty(rng));
+        }
+    }
+    return messages;
+}
+
+// what handle_depth does with a message
+void fill(const depth_message& message, batched_tick_update& ticks) {
+    ticks.set_exchange((uint32_t) exchange_t::binance);
+    ticks.set_symbol_id(0);
+    ticks.set_tick_id(message.event_time);
+    auto update_ticks = [&] (const std::vector<std::pair<double, double>>& levels, side_t side) {
+        for (const auto& level : levels) {
+            auto& tick = *ticks.add_updates();
+            tick.set_tick_id(message.event_time);
+            tick.set_price(level.first);
+            tick.set_quantity(level.second);
+            tick.set_side((uint8_t) side);
+        }
+    };
+    update_ticks(message.bids, side_t::bid);
+    update_ticks(message.asks, side_t::ask);
+}
+
+struct result {
+    double allocations = 0;     // per message
+    double ns = 0;              // per message
+};
+
+template <typename F>
+result measure(size_t messages, F&& f) {
+    // a first pass to warm up, as a link or a client would be
+    f();
+    size_t before = allocations;
+    int64_t start = bench::thread_cpu_ns();
+    f();
+    result r;
+    r.ns = (double) (bench::thread_cpu_ns() - start) / messages;
+    r.allocations = (double) (allocations - before) / messages;
+    return r;
+}
+
+void report(const char* path, const result& before, const result& after, const result* reused = nullptr) {
+    printf("%-26s  %13.2f  %12.2f  %10.0f  %9.0f", path, before.allocations, after.allocations, before.ns, after.ns);
+    if (reused)
+        printf("  %14.2f  %9.0f", reused->allocations, reused->ns);
+    printf("\n");
+}
+
+// the client side: Read() parses each message, then the compact levels are decoded
+void client_path(const char* path, const std::vector<std::string>& wire) {
+    uint64_t check = 0;
+    batched_tick_update decoded;
+    auto receive = [&] (const batched_tick_update& ticks) {
+        if (ticks.has_levels()) {
+            wire_codec::decode(ticks, decoded);
+            check += decoded.updates_size();
+        } else {
+            check += ticks.updates_size();
+        }
+    };
+    auto read = [&] (const batched_tick_update& message) {
+        if (message.batches_size() == 0)
+            receive(message);
+        for (const auto& batch : message.batches())
+            receive(batch);
+    };
+
+    result fresh = measure(wire.size(), [&] {
+        for (const auto& message : wire) {
+            batched_tick_update ticks;
+            ticks.ParseFromString(message);
+            read(ticks);
+        }
+    });
+    batched_tick_update kept;
+    result reused = measure(wire.size(), [&] {
+        for (const auto& message : wire) {
+            kept.ParseFromString(message);
+            read(kept);
+        }
+    });
+    read_arena arena;
+    result on_arena = measure(wire.size(), [&] {
+        for (const auto& message : wire) {
+            batched_tick_update* ticks = arena.next();
+            ticks->ParseFromString(message);
+            read(*ticks);
+        }
+    });
+    if (check == 0)
+        printf("nothing read\n");
+    report(path, fresh, on_arena, &reused);
+}
+
+}   // namespace
+
+int main(int argc, char **argv)
+{
+    absl::ParseCommandLine(argc, argv);
+    int n = absl::GetFlag(FLAGS_messages);
+    int levels = absl::GetFlag(FLAGS_levels);
+    int coalesced = absl::GetFlag(FLAGS_coalesced);
+
+    std::mt19937 rng(44);
+    auto messages = make_messages(rng, n, levels);
+
+    printf("up to %d levels per batch, %d batches per coalesced message\n", levels, coalesced);
+    printf("path                        allocs before  allocs after  ns before  ns after  allocs reused  ns reused\n");
+
+    uint64_t check = 0;
+    result before = measure(messages.size(), [&] {
+        for (const auto& message : messages) {
+            batched_tick_update ticks;
+            fill(message, ticks);
+            check += ticks.updates_size();
+        }
+    });
+    batched_tick_update kept;
+    result after = measure(messages.size(), [&] {
+        for (const auto& message : messages) {
+            kept.Clear();
+            fill(message, kept);
+            check += kept.updates_size();
+        }
+    });
+    report("link handle_depth", before, after);
+
+    std::vector<batched_tick_update> batches;
+    wire_codec::scale scale;
+    for (const auto& message : messages) {
+        batches.emplace_back();
+        fill(message, batches.back());
+        wire_codec::fit(batches.back(), scale);
+    }
+    for (auto encoding : {agg_proto::encoding_updates, agg_proto::encoding_delta}) {
+        std::vector<std::string> wire(batches.size());
+        batched_tick_update encoded;
+        for (size_t i = 0; i < batches.size(); ++i) {
+            if (encoding != agg_proto::encoding_updates && wire_codec::encode(batches[i], scale, encoded, true))
+                encoded.SerializeToString(&wire[i]);
+            else
+                batches[i].SerializeToString(&wire[i]);
+        }
+        std::string path = "client " + agg_proto::wire_encoding_Name(encoding).substr(9);
+        client_path(path.c_str(), wire);
+
+        // the same batches, coalesced as the server writes them to a client behind
+        std::vector<std::string> framed;
+        for (size_t i = 0; i + coalesced <= wire.size(); i += coalesced) {
+            batched_tick_update message;
+            for (int j = 0; j < coalesced; ++j)
+                message.add_batches()->ParseFromString(wire[i + j]);
+            framed.push_back(message.SerializeAsString());
+        }
+        path += " coalesced";
+        client_path(path.c_str(), framed);
+    }
+    if (check == 0)
+        printf("nothing built\n");
+    return 0;
+}
@@ -0,0 +1,161 @@
+
+// Read latency of the shared memory bbo table (shm_bbo) while it is written.
+//
+// A writer thread updates the quotes of --symbols entries round robin,
+// either not at all, at --rate updates a second, or as fast as it can; the
+// reader reads the entries round robin for --seconds and times every read,
+// retries of a read racing a write included. Then the reader spins on the
+// sequence of one entry and records how long each new quote took to be
+// seen, from the time the writer stamped in its tick_id.
+// With fewer cores than the two threads they take turns rather than race,
+// so the retries and the time to see a quote show the scheduler.
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+
+#include "bench_util.h"
+#include "../shm_bbo.h"
+
+ABSL_FLAG(std::string, table, "agg_bench_bbo", "Name of the shared memory table");
+ABSL_FLAG(int, symbols, 16, "Entries written and read");
+ABSL_FLAG(int, rate, 100000, "Updates a second of the paced writer");
+ABSL_FLAG(int, seconds, 2, "Seconds of each run");
+
+namespace {
+
+shm_bbo::quote make_quote(uint64_t n) {
+    shm_bbo::quote q;
+    q.bid.price = 100000 - (n % 100) * 0.01;
+    q.ask.price = 100000 + (n % 100) * 0.01;
+    for (uint32_t i = 0; i < shm_bbo::venues; ++i) {
+        q.bid.qty[i] = 1 + (n + i) % 7;
+        q.ask.qty[i] = 1 + (n + i) % 5;
+    }
+    q.tick_id = bench::now_ns();
+    q.publish_sequence = n;
+    return q;
+}
+
+// Updates the entries round robin until stopped, rate a second or flat out
+// if 0. Counts the quotes written.
+class writer_thread {
+public:
+    writer_thread(shm_bbo::writer& table, int symbols, int rate)
+        : thread_([this, &table, symbols, rate] {
+            int64_t period = rate > 0 ? 1'000'000'000LL / rate : 0;
+            int64_t next = bench::now_ns();
+            for (uint64_t n = 1; !stop_.load(std::memory_order_relaxed); ++n) {
+                if (period > 0) {
+                    while (bench::now_ns() < next)
+                        std::this_thread::yield();
+                    next += period;
+                }
+                table.update(n % symbols, make_quote(n));
+                written_.store(n, std::memory_order_relaxed);
+            }
+        }) {}
+
+    ~writer_thread() {
+        stop_ = true;
+        thread_.join();
+    }
+
+    uint64_t written() const { return written_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> stop_{false};
+    std::atomic<uint64_t> written_{0};
+    std::thread thread_;
+};
+
+void read_latency(shm_bbo::writer& table, const char* writes, int rate) {
+    shm_bbo::reader reader;
+    reader.open(absl::GetFlag(FLAGS_table));
+    int symbols = absl::GetFlag(FLAGS_symbols);
+    std::vector<int64_t> latencies;
+    latencies.reserve(1 << 24);
+    uint64_t retries = 0;
+    uint64_t written = 0;
+    {
+        std::unique_ptr<writer_thread> writer;
+        if (rate >= 0)
+            writer = std::make_unique<writer_thread>(table, symbols, rate);
+        int64_t end = bench::now_ns() + absl::GetFlag(FLAGS_seconds) * 1'000'000'000LL;
+        shm_bbo::quote q;
+        uint64_t sequence;
+        for (size_t i = 0; latencies.size() < latencies.capacity(); ++i) {
+            int64_t start = bench::now_ns();
+            if (start > end)
+                break;
+            size_t index = i % symbols;
+            for (uint32_t attempt = 1; !reader.try_read(index, q, sequence); ++attempt) {
+                ++retries;
+                if (attempt % 64 == 0)
+                    std::this_thread::yield();  // as reader::read does
+            }
+            latencies.push_back(bench::now_ns() - start);
+        }
+        if (writer)
+            written = writer->written();
+    }
+    printf("%-10s  %9zu  %10lu  %7ld  %7ld  %8ld  %9ld  %9.2f\n", writes, latencies.size(), written,
+        bench::percentile(latencies, 0.5), bench::percentile(latencies, 0.99),
+        bench::percentile(latencies, 0.999), bench::percentile(latencies, 1),
+        retries * 1e6 / std::max<size_t>(1, latencies.size()));
+    fflush(stdout);
+}
+
+// from the writer stamping a quote to the reader spinning on its entry seeing it
+void visibility(shm_bbo::writer& table, int rate) {
+    shm_bbo::reader reader;
+    reader.open(absl::GetFlag(FLAGS_table));
+    std::vector<int64_t> latencies;
+    {
+        writer_thread writer(table, 1, rate);
+        int64_t end = bench::now_ns() + absl::GetFlag(FLAGS_seconds) * 1'000'000'000LL;
+        uint64_t last = reader.sequence(0);
+        shm_bbo::quote q;
+        while (bench::now_ns() < end) {
+            if (reader.sequence(0) == last || !reader.read(0, q, last))
+                continue;
+            latencies.push_back(bench::now_ns() - q.tick_id);
+        }
+    }
+    printf("quotes seen %zu at %d/s: p50 %ld ns  p99 %ld ns  p999 %ld ns  max %ld ns\n", latencies.size(), rate,
+        bench::percentile(latencies, 0.5), bench::percentile(latencies, 0.99),
+        bench::percentile(latencies, 0.999), bench::percentile(latencies, 1));
+}
+
+}   // namespace
+
+int main(int argc, char **argv)
+{
+    absl::ParseCommandLine(argc, argv);
+    int symbols = std::max(1, absl::GetFlag(FLAGS_symbols));
+    absl::SetFlag(&FLAGS_symbols, symbols);
+    int rate = std::max(1, absl::GetFlag(FLAGS_rate));
+
+    shm_bbo::writer table;
+    if (!table.open(absl::GetFlag(FLAGS_table), symbols))
+        return 1;
+    for (int i = 0; i < symbols; ++i) {
+        table.name(i, "SYMBOL" + std::to_string(i));
+        table.update(i, make_quote(i));
+    }
+
+    printf("%u cores, %d symbols\n", std::thread::hardware_concurrency(), symbols);
+    printf("writes          reads     written  p50(ns)  p99(ns)  p999(ns)  max(ns)  retries/M\n");
+    read_latency(table, "none", -1);
+    std::string paced = std::to_string(rate) + "/s";
+    read_latency(table, paced.c_str(), rate);
+    read_latency(table, "flat out", 0);
+    visibility(table, rate);
+    return 0;
+}
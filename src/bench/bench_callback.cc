@@ -0,0 +1,141 @@
+
+// The callback API server against the completion queue server, with the same
+// load generator (bench::stream_sink) for both.
+//
+// Throughput: batches are published as fast as the clients take them, with
+// at most --window batches not yet read by every client, and the messages
+// read per second are reported. Latency: batches are published at --rate,
+// from publication to the client read. Modes: cq is the single queue polled
+// from the publishing thread (the default server), cq1 one queue thread,
+// callback the callback_server.
+
+#include <cstdio>
+#include <random>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+
+#include "bench_util.h"
+#include "../server/callback_server.h"
+
+ABSL_FLAG(uint16_t, port, 50170, "Port of the first in-process server, the next ones take the following ports");
+ABSL_FLAG(std::vector<std::string>, clients, std::vector<std::string>({"10", "100"}), "Client counts");
+ABSL_FLAG(int, batches, 5000, "Batches published per throughput run");
+ABSL_FLAG(int, window, 16, "Batches published ahead of the slowest client in the throughput run");
+ABSL_FLAG(int, rate, 1000, "Batches per second of the latency run");
+ABSL_FLAG(int, seconds, 2, "Seconds of the latency run");
+ABSL_FLAG(int, levels, 20, "Levels per batch");
+ABSL_FLAG(int, sinks, 4, "Client threads");
+
+namespace {
+
+struct result {
+    double messages_per_s = 0;
+    int64_t p50 = 0;
+    int64_t p99 = 0;
+};
+
+uint64_t received(const std::vector<std::unique_ptr<bench::stream_sink>>& sinks) {
+    uint64_t n = 0;
+    for (const auto& sink : sinks)
+        n += sink->received();
+    return n;
+}
+
+// poll runs the server between two batches, if it needs to be driven
+template <typename Server, typename Poll>
+result run(Server& server, Poll&& poll, const std::string& target, size_t clients,
+    const std::vector<batched_tick_update>& samples, symbol_id_t symbol) {
+    std::vector<std::unique_ptr<bench::stream_sink>> sinks;
+    for (int i = 0; i < absl::GetFlag(FLAGS_sinks); ++i)
+        sinks.push_back(std::make_unique<bench::stream_sink>(target));
+    for (size_t i = 0; i < clients; ++i)
+        sinks[i % sinks.size()]->add_streams(1);
+    while (server.streams() < clients)
+        poll();
+
+    result r;
+    batched_tick_update ticks;
+    // throughput, a window of batches in flight
+    int batches = absl::GetFlag(FLAGS_batches);
+    uint64_t window = absl::GetFlag(FLAGS_window);
+    uint64_t base = received(sinks);
+    int64_t start = bench::now_ns();
+    for (int i = 0; i < batches; ++i) {
+        while ((i - (received(sinks) - base) / clients) >= window)
+            poll();
+        ticks = samples[i % samples.size()];
+        ticks.set_tick_id(bench::now_ns());
+        server.process_tick(symbol, ticks);
+    }
+    while (received(sinks) - base < (uint64_t) batches * clients)
+        poll();
+    r.messages_per_s = (double) batches * clients * 1e9 / (bench::now_ns() - start);
+
+    // latency at a fixed rate
+    for (auto& sink : sinks)
+        sink->take_latencies();
+    int64_t period = 1'000'000'000LL / absl::GetFlag(FLAGS_rate);
+    int paced = absl::GetFlag(FLAGS_rate) * absl::GetFlag(FLAGS_seconds);
+    base = received(sinks);
+    int64_t next = bench::now_ns();
+    for (int i = 0; i < paced; ++i) {
+        while (bench::now_ns() < next)
+            poll();
+        ticks = samples[i % samples.size()];
+        ticks.set_tick_id(bench::now_ns());
+        server.process_tick(symbol, ticks);
+        next += period;
+    }
+    while (received(sinks) - base < (uint64_t) paced * clients)
+        poll();
+    std::vector<int64_t> latencies;
+    for (auto& sink : sinks) {
+        auto l = sink->take_latencies();
+        latencies.insert(latencies.end(), l.begin(), l.end());
+    }
+    r.p50 = bench::percentile(latencies, 0.5);
+    r.p99 = bench::percentile(latencies, 0.99);
+    return r;
+}
+
+}   // namespace
+
+int main(int argc, char **argv)
+{
+    absl::ParseCommandLine(argc, argv);
+    uint16_t port = absl::GetFlag(FLAGS_port);
+
+    symbol_registry symbols;
+    symbol_id_t symbol = symbols.intern("BTCUSDT");
+    std::mt19937 rng(42);
+    std::vector<batched_tick_update> samples;
+    for (int i = 0; i < 64; ++i)
+        samples.push_back(bench::make_batch(rng, 1 + i % 3, absl::GetFlag(FLAGS_levels)));
+
+    printf("%u cores\n", std::thread::hardware_concurrency());
+    printf("mode      clients  messages/s  p50(us)  p99(us)\n");
+    for (const auto& c : absl::GetFlag(FLAGS_clients)) {
+        size_t clients = std::stoul(c);
+        auto report = [&] (const char* mode, const result& r) {
+            printf("%-8s  %7zu  %10.0f  %7.0f  %7.0f\n", mode, clients, r.messages_per_s, r.p50 / 1e3, r.p99 / 1e3);
+            fflush(stdout);
+        };
+        {
+            aggregator_server server(port, symbols);
+            report("cq", run(server, [&] { server.poll_non_block(); }, "localhost:" + std::to_string(port++),
+                clients, samples, symbol));
+        }
+        {
+            aggregator_server server(port, symbols, {}, 1);
+            report("cq1", run(server, [] { std::this_thread::yield(); }, "localhost:" + std::to_string(port++),
+                clients, samples, symbol));
+        }
+        {
+            callback_server server(port, symbols);
+            report("callback", run(server, [] { std::this_thread::yield(); }, "localhost:" + std::to_string(port++),
+                clients, samples, symbol));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+
+// Consolidated depth streams against the raw exchange batches.
+//
+// One client per mode (raw, and each --depths value) subscribes to the same
+// in-process server, then the same batches are published. Each client reads
+// on its own thread and applies every batch to an extended_book; it reports
+// the bytes received (protobuf size, without gRPC framing) and the CPU time
+// of its thread.
+
+#include <cstdio>
+#include <random>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+
+#include "bench_util.h"
+#include "../client/orderbook.h"
+#include "../server/aggregator_server.h"
+
+ABSL_FLAG(uint16_t, port, 50152, "Port of the in-process server");
+ABSL_FLAG(int, batches, 20000, "Batches published");
+ABSL_FLAG(int, levels, 20, "Levels per batch");
+ABSL_FLAG(std::vector<std::string>, depths, std::vector<std::string>({"1", "5", "10"}), "Depths to compare with the raw stream");
+
+namespace {
+
+const int64_t last_tick_id = -1;
+
+struct result {
+    uint32_t depth = 0;
+    uint64_t messages = 0;
+    uint64_t bytes = 0;
+    int64_t cpu_ns = 0;
+    std::atomic<bool> done{false};
+};
+
+void read_stream(const std::string& target, result& r) {
+    auto stub = agg_service::NewStub(grpc::CreateChannel(target, grpc::InsecureChannelCredentials()));
+    grpc::ClientContext context;
+    tick_request request;
+    request.set_symbol("BTCUSDT");
+    request.set_depth(r.depth);
+    auto reader = stub->TickBatchedStreamRequest(&context, request);
+
+    order_book::extended_book book;
+    batched_tick_update ticks;
+    int64_t cpu0 = bench::thread_cpu_ns();
+    while (reader->Read(&ticks)) {
+        ++r.messages;
+        r.bytes += ticks.ByteSizeLong();
+        book.update_ticks(ticks);
+        if (ticks.tick_id() == last_tick_id)
+            break;
+    }
+    r.cpu_ns = bench::thread_cpu_ns() - cpu0;
+    r.done.store(true, std::memory_order_release);
+    context.TryCancel();
+    reader->Finish();
+}
+
+}   // namespace
+
+int main(int argc, char **argv)
+{
+    absl::ParseCommandLine(argc, argv);
+    uint16_t port = absl::GetFlag(FLAGS_port);
+    int batches = absl::GetFlag(FLAGS_batches);
+    std::string target = "localhost:" + std::to_string(port);
+
+    symbol_registry symbols;
+    symbol_id_t symbol = symbols.intern("BTCUSDT");
+    aggregator_server server(port, symbols);
+
+    std::vector<std::unique_ptr<result>> results;
+    results.push_back(std::make_unique<result>());
+    for (const auto& depth : absl::GetFlag(FLAGS_depths)) {
+        results.push_back(std::make_unique<result>());
+        results.back()->depth = std::stoul(depth);
+    }
+    std::vector<std::thread> readers;
+    for (auto& r : results)
+        readers.emplace_back(read_stream, target, std::ref(*r));
+    while (server.clients().size() < results.size())
+        server.poll_non_block();
+
+    std::mt19937 rng(42);
+    auto drain = [&] {
+        auto busy = [&] {
+            for (auto* client : server.clients())
+                if (client->queue_depth() > 0) return true;
+            return false;
+        };
+        while (busy())
+            server.poll_block();
+    };
+    for (int i = 0; i < batches; ++i) {
+        server.process_tick(symbol, bench::make_batch(rng, 1 + i % 3, absl::GetFlag(FLAGS_levels)));
+        drain();
+    }
+
+    // a new best bid ends every stream, whatever its depth
+    batched_tick_update last;
+    last.set_symbol_id(symbol);
+    last.set_exchange(1);
+    last.set_tick_id(last_tick_id);
+    auto& tick = *last.add_updates();
+    tick.set_side((uint32_t) side_t::bid);
+    tick.set_price(1'000'000);
+    tick.set_quantity(1);
+    server.process_tick(symbol, last);
+    auto all_done = [&] {
+        for (auto& r : results)
+            if (!r->done.load(std::memory_order_acquire)) return false;
+        return true;
+    };
+    while (!all_done())
+        server.poll_non_block();
+    for (auto& t : readers)
+        t.join();
+
+    const result& raw = *results[0];
+    printf("stream   messages  bytes/batch  client cpu/batch(us)  bytes vs raw  cpu vs raw\n");
+    for (auto& r : results) {
+        std::string name = r->depth == 0 ? "raw" : "depth " + std::to_string(r->depth);
+        printf("%-8s %9lu  %11.1f  %20.2f  %11.1f%%  %9.1f%%\n", name.c_str(), (unsigned long) r->messages,
+            (double) r->bytes / batches, r->cpu_ns / 1e3 / batches,
+            100.0 * r->bytes / raw.bytes, 100.0 * r->cpu_ns / raw.cpu_ns);
+    }
+
+    return 0;
+}
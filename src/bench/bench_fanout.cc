@@ -0,0 +1,95 @@
+
+// Server CPU spent on fan-out, from 1 to 500 local clients.
+//
+// Publishes batches through aggregator_server::process_tick and drives the
+// completion queue until every client queue is empty, measuring the CPU time
+// of the server thread only. Clients read on their own thread.
+//
+// With --burst N, N batches are published before the queues are drained, so
+// that they build up as for a client falling behind; with --coalesce the
+// clients take them in fewer writes. Reports how many batches each write
+// carried.
+
+#include <cstdio>
+#include <random>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+
+#include "bench_util.h"
+#include "../server/aggregator_server.h"
+
+ABSL_FLAG(uint16_t, port, 50151, "Port of the in-process server");
+ABSL_FLAG(int, batches, 2000, "Batches published per client count");
+ABSL_FLAG(int, levels, 20, "Levels per batch");
+ABSL_FLAG(bool, coalesce, false, "Clients ask for coalesced writes");
+ABSL_FLAG(int, burst, 1, "Batches published between two rounds of writes");
+
+int main(int argc, char **argv)
+{
+    absl::ParseCommandLine(argc, argv);
+    uint16_t port = absl::GetFlag(FLAGS_port);
+    int batches = absl::GetFlag(FLAGS_batches);
+
+    symbol_registry symbols;
+    symbol_id_t symbol = symbols.intern("BTCUSDT");
+    aggregator_server server(port, symbols);
+    bench::stream_sink sink("localhost:" + std::to_string(port));
+
+    std::mt19937 rng(42);
+    std::vector<batched_tick_update> samples;
+    for (int i = 0; i < 64; ++i)
+        samples.push_back(bench::make_batch(rng, 1 + i % 3, absl::GetFlag(FLAGS_levels)));
+
+    tick_request request;
+    request.set_symbol("BTCUSDT");
+    request.set_coalesce(absl::GetFlag(FLAGS_coalesce));
+    int burst = std::max(1, absl::GetFlag(FLAGS_burst));
+
+    auto write_sizes = [&] {
+        client_queue_stats total;
+        for (auto* client : server.clients())
+            for (size_t b = 0; b < total.write_sizes.size(); ++b)
+                total.write_sizes[b] += client->stats().write_sizes[b];
+        return total;
+    };
+
+    printf("clients  cpu/batch(us)  cpu/batch/client(ns)  batches/s  batches per write\n");
+    for (size_t clients : {1, 10, 50, 100, 250, 500}) {
+        sink.add_streams(clients - sink.size(), request);
+        while (server.clients().size() < clients)
+            server.poll_non_block();
+
+        client_queue_stats sizes0 = write_sizes();
+        uint64_t expected = sink.received() + (uint64_t) batches * clients;
+        int64_t wall0 = bench::now_ns();
+        int64_t cpu0 = bench::thread_cpu_ns();
+        for (int i = 0; i < batches; ++i) {
+            server.process_tick(symbol, samples[i % samples.size()]);
+            if ((i + 1) % burst != 0 && i + 1 < batches)
+                continue;
+            // keep the server busy as long as some client still has a write queued
+            auto busy = [&] {
+                for (auto* client : server.clients())
+                    if (client->queue_depth() > 0) return true;
+                return false;
+            };
+            while (busy())
+                server.poll_block();
+        }
+        int64_t cpu = bench::thread_cpu_ns() - cpu0;
+        int64_t wall = bench::now_ns() - wall0;
+        while (sink.received() < expected)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        client_queue_stats sizes = write_sizes();
+        for (size_t b = 0; b < sizes.write_sizes.size(); ++b)
+            sizes.write_sizes[b] -= sizes0.write_sizes[b];
+        printf("%7zu  %13.2f  %20.1f  %9.0f  %s\n", clients,
+            cpu / 1e3 / batches, (double) cpu / batches / clients, batches * 1e9 / wall,
+            sizes.write_size_distribution().c_str());
+        fflush(stdout);
+    }
+
+    return 0;
+}
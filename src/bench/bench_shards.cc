@@ -0,0 +1,158 @@
+
+// Clients served within a p99 latency target, per completion queue thread.
+//
+// For each --threads value an in-process server is started (0 is the single
+// queue polled from the publishing thread, as server.cc does by default),
+// then clients are added step by step while batches are published at a
+// fixed rate. The latency is measured from publication to the client read.
+// Reports p50 / p99 of each step, and the most clients kept under --p99_us.
+
+#include <cstdio>
+#include <limits>
+#include <random>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+
+#include "bench_util.h"
+#include "../server/aggregator_server.h"
+
+ABSL_FLAG(uint16_t, port, 50153, "Port of the first in-process server, the next ones take the following ports");
+ABSL_FLAG(std::vector<std::string>, threads, std::vector<std::string>({"0", "1", "2", "4"}), "Completion queue threads to compare");
+ABSL_FLAG(std::vector<std::string>, clients, std::vector<std::string>({"50", "100", "200", "400", "800"}), "Client counts, in increasing order");
+ABSL_FLAG(int, rate, 1000, "Batches published per second");
+ABSL_FLAG(int, seconds, 2, "Seconds measured per client count");
+ABSL_FLAG(int, levels, 20, "Levels per batch");
+ABSL_FLAG(int, p99_us, 5000, "Latency target");
+ABSL_FLAG(int, sinks, 4, "Client threads");
+
+namespace {
+
+struct step_result {
+    int64_t p50 = 0;
+    int64_t p99 = 0;
+    uint64_t received = 0;
+    uint64_t expected = 0;
+};
+
+// publishes at the rate for the duration, polling the single queue in between if there is one
+step_result run_step(aggregator_server& server, bool threaded, std::vector<std::unique_ptr<bench::stream_sink>>& sinks,
+    const std::vector<batched_tick_update>& samples, symbol_id_t symbol, size_t clients) {
+    int rate = absl::GetFlag(FLAGS_rate);
+    int64_t period = 1'000'000'000LL / rate;
+    int batches = rate * absl::GetFlag(FLAGS_seconds);
+
+    for (auto& sink : sinks)
+        sink->take_latencies();
+    uint64_t received0 = 0;
+    for (auto& sink : sinks)
+        received0 += sink->received();
+
+    batched_tick_update ticks;
+    int64_t next = bench::now_ns();
+    for (int i = 0; i < batches; ++i) {
+        while (bench::now_ns() < next) {
+            if (threaded)
+                std::this_thread::yield();
+            else
+                server.poll_non_block();
+        }
+        ticks = samples[i % samples.size()];
+        ticks.set_tick_id(bench::now_ns());
+        server.process_tick(symbol, ticks);
+        next += period;
+    }
+    // what is still queued, for at most one second
+    step_result r;
+    r.expected = (uint64_t) batches * clients;
+    int64_t drain_end = bench::now_ns() + 1'000'000'000LL;
+    while (bench::now_ns() < drain_end) {
+        r.received = 0;
+        for (auto& sink : sinks)
+            r.received += sink->received();
+        r.received -= received0;
+        if (r.received >= r.expected)
+            break;
+        if (threaded)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        else
+            server.poll_non_block();
+    }
+
+    std::vector<int64_t> latencies;
+    for (auto& sink : sinks) {
+        auto l = sink->take_latencies();
+        latencies.insert(latencies.end(), l.begin(), l.end());
+    }
+    r.p50 = bench::percentile(latencies, 0.5);
+    r.p99 = bench::percentile(latencies, 0.99);
+    // a message never received is over any target
+    if (r.received < r.expected)
+        r.p99 = std::numeric_limits<int64_t>::max();
+    return r;
+}
+
+}   // namespace
+
+int main(int argc, char **argv)
+{
+    absl::ParseCommandLine(argc, argv);
+    uint16_t port = absl::GetFlag(FLAGS_port);
+    int64_t target = absl::GetFlag(FLAGS_p99_us) * 1000LL;
+
+    symbol_registry symbols;
+    symbol_id_t symbol = symbols.intern("BTCUSDT");
+    std::mt19937 rng(42);
+    std::vector<batched_tick_update> samples;
+    for (int i = 0; i < 64; ++i)
+        samples.push_back(bench::make_batch(rng, 1 + i % 3, absl::GetFlag(FLAGS_levels)));
+
+    printf("%u cores, %d batches/s, p99 target %d us\n", std::thread::hardware_concurrency(),
+        absl::GetFlag(FLAGS_rate), absl::GetFlag(FLAGS_p99_us));
+    printf("threads  clients  p50(us)  p99(us)  received\n");
+    std::vector<std::string> summary;
+    for (const auto& t : absl::GetFlag(FLAGS_threads)) {
+        size_t threads = std::stoul(t);
+        aggregator_server server(port, symbols, {}, threads);
+        std::string target_address = "localhost:" + std::to_string(port++);
+        std::vector<std::unique_ptr<bench::stream_sink>> sinks;
+        for (int i = 0; i < absl::GetFlag(FLAGS_sinks); ++i)
+            sinks.push_back(std::make_unique<bench::stream_sink>(target_address));
+
+        size_t best = 0;
+        size_t connected = 0;
+        for (const auto& c : absl::GetFlag(FLAGS_clients)) {
+            size_t clients = std::stoul(c);
+            for (size_t i = connected; i < clients; ++i)
+                sinks[i % sinks.size()]->add_streams(1);
+            connected = clients;
+            while (server.streams() < clients) {
+                if (threads == 0)
+                    server.poll_non_block();
+                else
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+
+            step_result r = run_step(server, threads > 0, sinks, samples, symbol, clients);
+            bool within = r.p99 <= target;
+            if (r.received < r.expected)
+                printf("%7zu  %7zu  %7.0f  %7s  %llu/%llu\n", threads, clients, r.p50 / 1e3, "-",
+                    (unsigned long long) r.received, (unsigned long long) r.expected);
+            else
+                printf("%7zu  %7zu  %7.0f  %7.0f  %llu\n", threads, clients, r.p50 / 1e3, r.p99 / 1e3,
+                    (unsigned long long) r.received);
+            fflush(stdout);
+            if (!within)
+                break;
+            best = clients;
+        }
+        size_t cores = std::max<size_t>(1, threads);
+        summary.push_back(absl::StrFormat("%7zu  %11zu  %15.0f", threads, best, (double) best / cores));
+        sinks.clear();
+    }
+
+    printf("\nthreads  max clients  clients/thread\n");
+    for (const auto& line : summary)
+        printf("%s\n", line.c_str());
+    return 0;
+}
@@ -0,0 +1,121 @@
+
+// Latency of a batch from process_tick to the process_ticks of a base_client
+// on the same host, over the gRPC stream and over the shared memory ring
+// (aggregator_server_config::shm_ring_name, base_client::subscribe_shm).
+//
+// A server with a queue thread and one client reading on its own thread, one
+// transport after the other: the shared memory client spins on the ring, it
+// would take the cores of the other. The publisher paces --rate batches a
+// second for --seconds, each stamped with the time it is published (tick_id).
+
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <thread>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+
+#include "bench_util.h"
+#include "../client/base_client.h"
+#include "../server/aggregator_server.h"
+
+ABSL_FLAG(uint16_t, port, 50190, "Port of the in-process server");
+ABSL_FLAG(std::string, shm_ring, "agg_bench_transport", "Name of the shared memory ring");
+ABSL_FLAG(int, rate, 10000, "Batches published per second");
+ABSL_FLAG(int, seconds, 5, "Seconds of publishing");
+ABSL_FLAG(int, levels, 20, "Levels per batch");
+
+namespace {
+
+class latency_client : public base_client<latency_client> {
+public:
+    explicit latency_client(const std::string& target) : base_client<latency_client>(target) {
+        latencies_.reserve(1 << 20);
+    }
+
+    void process_ticks(const batched_tick_update& ticks) {
+        if (ticks.flag() != (uint64_t) updata_flag_t::snapshot)
+            latencies_.push_back(bench::now_ns() - ticks.tick_id());
+        received_.fetch_add(1, std::memory_order_release);
+    }
+
+    uint64_t received() const { return received_.load(std::memory_order_acquire); }
+
+    // read once its thread is joined
+    const std::vector<int64_t>& latencies() const { return latencies_; }
+
+private:
+    std::vector<int64_t> latencies_;
+    std::atomic<uint64_t> received_{0};
+};
+
+void report(const char* transport, const std::vector<int64_t>& latencies) {
+    printf("%-9s  %8zu  %7.1f  %7.1f  %8.1f  %7.1f\n", transport, latencies.size(),
+        bench::percentile(latencies, 0.5) / 1e3, bench::percentile(latencies, 0.99) / 1e3,
+        bench::percentile(latencies, 0.999) / 1e3, bench::percentile(latencies, 1) / 1e3);
+    fflush(stdout);
+}
+
+std::vector<int64_t> run(bool shm, uint16_t port, const std::vector<batched_tick_update>& samples) {
+    std::string target = "localhost:" + std::to_string(port);
+    symbol_registry symbols;
+    symbol_id_t symbol = symbols.intern("BTCUSDT");
+    aggregator_server_config server_config;
+    if (shm)
+        server_config.shm_ring_name = absl::GetFlag(FLAGS_shm_ring);
+    aggregator_server server(port, symbols, {}, 1, server_config);
+    latency_client client(target);
+    if (shm) {
+        client.subscribe_shm({"BTCUSDT"}, absl::GetFlag(FLAGS_shm_ring));
+    } else {
+        client.subscribe_symbol("BTCUSDT");
+        while (server.streams() < 1)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::atomic<bool> stop{false};
+    std::thread reader([&] {
+        while (!stop.load(std::memory_order_acquire))
+            client.poll(std::chrono::system_clock::now() + std::chrono::milliseconds(10));
+    });
+
+    int64_t period = 1'000'000'000LL / absl::GetFlag(FLAGS_rate);
+    int paced = absl::GetFlag(FLAGS_rate) * absl::GetFlag(FLAGS_seconds);
+    int64_t next = bench::now_ns();
+    batched_tick_update ticks;
+    for (int i = 0; i < paced; ++i) {
+        while (bench::now_ns() < next)
+            std::this_thread::yield();
+        ticks = samples[i % samples.size()];
+        ticks.set_tick_id(bench::now_ns());
+        server.process_tick(symbol, ticks);
+        next += period;
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (client.received() < (uint64_t) paced && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    stop.store(true, std::memory_order_release);
+    reader.join();
+    return client.latencies();
+}
+
+}   // namespace
+
+int main(int argc, char **argv)
+{
+    absl::ParseCommandLine(argc, argv);
+    uint16_t port = absl::GetFlag(FLAGS_port);
+
+    std::mt19937 rng(42);
+    std::vector<batched_tick_update> samples;
+    for (int i = 0; i < 64; ++i)
+        samples.push_back(bench::make_batch(rng, 1 + i % 3, absl::GetFlag(FLAGS_levels)));
+
+    printf("%u cores, %d batches of %d levels at %d/s\n", std::thread::hardware_concurrency(),
+        absl::GetFlag(FLAGS_rate) * absl::GetFlag(FLAGS_seconds), absl::GetFlag(FLAGS_levels), absl::GetFlag(FLAGS_rate));
+    printf("transport   batches  p50(us)  p99(us)  p999(us)  max(us)\n");
+    report("grpc", run(false, port, samples));
+    report("shm", run(true, port + 1, samples));
+    return 0;
+}
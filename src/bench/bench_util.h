@@ -0,0 +1,155 @@
+#ifndef _BENCH_UTIL_H_
+#define _BENCH_UTIL_H_
+
+#include <time.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+#include "../common.h"
+#include "../protos/aggregator.grpc.pb.h"
+
+using agg_proto::agg_service;
+using agg_proto::tick_request;
+using agg_proto::batched_tick_update;
+
+
+namespace bench {
+
+inline int64_t thread_cpu_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1'000'000'000LL + ts.tv_nsec;
+}
+
+inline int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// a depth update shaped like the exchange ones: levels around the touch on both sides
+inline batched_tick_update make_batch(std::mt19937& rng, uint32_t exchange, int levels, double mid = 100000) {
+    std::uniform_int_distribution<int> offset(1, 200);
+    std::uniform_real_distribution<double> qty(0, 5);
+    batched_tick_update ticks;
+    ticks.set_symbol_id(0);     // BTCUSDT, the first symbol interned
+    ticks.set_exchange(exchange);
+    ticks.set_tick_id(now_ns());
+    for (int i = 0; i < levels; ++i) {
+        auto& tick = *ticks.add_updates();
+        bool bid = i % 2 == 0;
+        tick.set_side((uint32_t) (bid ? side_t::bid : side_t::ask));
+        tick.set_price(bid ? mid - offset(rng) * 0.01 : mid + offset(rng) * 0.01);
+        tick.set_quantity(i % 5 == 0 ? 0 : qty(rng));
+        tick.set_tick_id(ticks.tick_id());
+    }
+    return ticks;
+}
+
+// N streaming subscribers driven by one completion queue thread.
+// Counts the batches received, coalesced ones included, and records the
+// latency of each one, from tick_id (set to now_ns() by the publisher) to
+// the moment it is read.
+class stream_sink {
+public:
+    explicit stream_sink(const std::string& target) : target_(target)
+    {
+        thread_ = std::thread([this] { run(); });
+    }
+
+    ~stream_sink() {
+        for (auto& s : streams_)
+            s->context.TryCancel();
+        cq_.Shutdown();
+        thread_.join();
+    }
+
+    void add_streams(size_t n, const tick_request& request = {}) {
+        for (size_t i = 0; i < n; ++i) {
+            // spread the streams over several connections, like separate client processes
+            if (streams_.size() % streams_per_channel == 0) {
+                grpc::ChannelArguments args;
+                args.SetInt("bench.channel", (int) stubs_.size());
+                stubs_.push_back(agg_service::NewStub(
+                    grpc::CreateCustomChannel(target_, grpc::InsecureChannelCredentials(), args)));
+            }
+            auto s = std::make_unique<stream>();
+            s->reader = stubs_.back()->PrepareAsyncTickBatchedStreamRequest(&s->context, request, &cq_);
+            s->reader->StartCall(s.get());
+            streams_.push_back(std::move(s));
+        }
+    }
+
+    size_t size() const { return streams_.size(); }
+    uint64_t received() const { return received_.load(std::memory_order_acquire); }
+
+    // latencies in ns, collected since the last call
+    std::vector<int64_t> take_latencies() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<int64_t> out;
+        out.swap(latencies_);
+        return out;
+    }
+
+private:
+    struct stream {
+        grpc::ClientContext context;
+        batched_tick_update ticks;
+        std::unique_ptr<grpc::ClientAsyncReader<batched_tick_update>> reader;
+        bool started = false;
+    };
+
+    void run() {
+        void* tag;
+        bool ok;
+        while (cq_.Next(&tag, &ok)) {
+            auto* s = static_cast<stream*>(tag);
+            if (!ok)
+                continue;
+            if (s->started) {
+                int64_t now = now_ns();
+                size_t batches = std::max(1, s->ticks.batches_size());
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (s->ticks.batches_size() == 0)
+                        latencies_.push_back(now - s->ticks.tick_id());
+                    for (const auto& ticks : s->ticks.batches())
+                        latencies_.push_back(now - ticks.tick_id());
+                }
+                received_.fetch_add(batches, std::memory_order_release);
+            }
+            s->started = true;
+            s->reader->Read(&s->ticks, s);
+        }
+    }
+
+    static constexpr size_t streams_per_channel = 50;
+
+    std::string target_;
+    std::vector<std::unique_ptr<agg_service::Stub>> stubs_;
+    grpc::CompletionQueue cq_;
+    std::vector<std::unique_ptr<stream>> streams_;
+    std::atomic<uint64_t> received_{0};
+    std::mutex mutex_;
+    std::vector<int64_t> latencies_;
+    std::thread thread_;
+};
+
+inline int64_t percentile(std::vector<int64_t> v, double p) {
+    if (v.empty()) return 0;
+    size_t k = std::min(v.size() - 1, (size_t) (p * v.size()));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+}   // namespace bench
+
+#endif  // _BENCH_UTIL_H_
@@ -0,0 +1,153 @@
+
+// Size and client decode time of the batch encodings (tick_request.encoding).
+//
+// The same exchange batches are serialized in each encoding. They are shaped
+// like the venue depth updates: the bids then the asks, each side from the
+// touch outwards over 200 ticks of 0.01, around a moving touch, with
+// quantities on a --lot grid.
+// Reports the bytes per batch and per level, and the client time to parse a
+// message and get its updates back (wire_codec::decode for the compact
+// levels), then to apply them to an extended_book as well. There is no
+// recording in the repository to replay, hence the generated batches.
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+
+#include "bench_util.h"
+#include "../client/orderbook.h"
+#include "../wire_codec.h"
+
+ABSL_FLAG(int, batches, 20000, "Batches encoded");
+ABSL_FLAG(int, levels, 20, "Levels per batch");
+ABSL_FLAG(double, lot, 0.00001, "Quantity grid");
+ABSL_FLAG(int, rounds, 5, "Passes over the batches, the fastest one is reported");
+
+namespace {
+
+std::vector<batched_tick_update> make_batches(std::mt19937& rng, int n, int levels, double lot) {
+    std::uniform_int_distribution<int> offset(1, 200);
+    std::uniform_int_distribution<int> move(-3, 3);
+    std::uniform_int_distribution<int64_t> lots(1, (int64_t) (5 / lot));
+    std::vector<int> offsets;
+    int64_t mid = 10'000'000;     // in ticks of 0.01
+    std::vector<batched_tick_update> batches(n);
+    for (int b = 0; b < n; ++b) {
+        auto& ticks = batches[b];
+        mid += move(rng);
+        ticks.set_symbol_id(0);
+        ticks.set_exchange(1 + b % 3);
+        ticks.set_tick_id(1'700'000'000'000 + b);
+        for (int i = 0; i < levels; ++i) {
+            bool bid = i < levels / 2;
+            if (i == 0 || i == levels / 2) {
+                int side_levels = bid ? levels / 2 : levels - levels / 2;
+                offsets.clear();
+                for (int j = 0; j < side_levels; ++j)
+                    offsets.push_back(offset(rng));
+                std::sort(offsets.begin(), offsets.end());
+            }
+            auto& tick = *ticks.add_updates();
+            tick.set_side((uint32_t) (bid ? side_t::bid : side_t::ask));
+            // as parsed from the decimal strings of the venues
+            int o = offsets[bid ? i : i - levels / 2];
+            int64_t price = bid ? mid - o : mid + o;
+            tick.set_price(std::stod(std::to_string(price / 100) + "." + std::to_string(100 + price % 100).substr(1)));
+            tick.set_quantity(i % 5 == 0 ? 0 : lots(rng) * lot);
+            tick.set_tick_id(ticks.tick_id());
+        }
+    }
+    return batches;
+}
+
+struct result {
+    double bytes_per_batch = 0;
+    double bytes_per_level = 0;
+    double decode_ns = 0;       // per batch, parse and updates
+    double apply_ns = 0;        // per batch, with the book update
+};
+
+template <typename F>
+double best_ns_per_batch(int rounds, size_t batches, F&& f) {
+    double best = 1e18;
+    for (int r = 0; r < rounds; ++r) {
+        int64_t start = bench::thread_cpu_ns();
+        f();
+        best = std::min(best, (double) (bench::thread_cpu_ns() - start) / batches);
+    }
+    return best;
+}
+
+result measure(const std::vector<batched_tick_update>& batches, agg_proto::wire_encoding encoding, int rounds) {
+    wire_codec::scale scale;
+    for (const auto& ticks : batches)
+        wire_codec::fit(ticks, scale);
+
+    std::vector<std::string> wire(batches.size());
+    size_t bytes = 0, levels = 0;
+    batched_tick_update encoded;
+    for (size_t i = 0; i < batches.size(); ++i) {
+        // as the server, updates for a batch out of the range of the scale
+        if (encoding != agg_proto::encoding_updates &&
+            wire_codec::encode(batches[i], scale, encoded, encoding == agg_proto::encoding_delta)) {
+            encoded.SerializeToString(&wire[i]);
+        } else {
+            batches[i].SerializeToString(&wire[i]);
+        }
+        bytes += wire[i].size();
+        levels += batches[i].updates_size();
+    }
+
+    result r;
+    r.bytes_per_batch = (double) bytes / batches.size();
+    r.bytes_per_level = (double) bytes / levels;
+
+    // what base_client does with each message read
+    batched_tick_update ticks, decoded;
+    uint64_t check = 0;
+    auto read = [&] (const std::string& message) -> const batched_tick_update& {
+        ticks.ParseFromString(message);
+        if (!ticks.has_levels())
+            return ticks;
+        wire_codec::decode(ticks, decoded);
+        return decoded;
+    };
+    r.decode_ns = best_ns_per_batch(rounds, wire.size(), [&] {
+        for (const auto& message : wire)
+            check += read(message).updates_size();
+    });
+    r.apply_ns = best_ns_per_batch(rounds, wire.size(), [&] {
+        order_book::extended_book book;
+        for (const auto& message : wire)
+            book.update_ticks(read(message));
+        check += book.best_bid().price > 0;
+    });
+    if (check == 0)
+        printf("nothing decoded\n");
+    return r;
+}
+
+}   // namespace
+
+int main(int argc, char **argv)
+{
+    absl::ParseCommandLine(argc, argv);
+    int levels = absl::GetFlag(FLAGS_levels);
+    int rounds = absl::GetFlag(FLAGS_rounds);
+
+    std::mt19937 rng(42);
+    auto batches = make_batches(rng, absl::GetFlag(FLAGS_batches), levels, absl::GetFlag(FLAGS_lot));
+
+    printf("%d levels per batch, quantities on a %g grid\n", levels, absl::GetFlag(FLAGS_lot));
+    printf("encoding  bytes/batch  bytes/level  decode(ns/batch)  decode+book(ns/batch)\n");
+    for (auto encoding : {agg_proto::encoding_updates, agg_proto::encoding_compact, agg_proto::encoding_delta}) {
+        result r = measure(batches, encoding, rounds);
+        printf("%-8s  %11.1f  %11.2f  %16.0f  %21.0f\n", agg_proto::wire_encoding_Name(encoding).substr(9).c_str(),
+            r.bytes_per_batch, r.bytes_per_level, r.decode_ns, r.apply_ns);
+    }
+    return 0;
+}
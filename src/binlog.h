@@ -0,0 +1,349 @@
+#ifndef _BINLOG_H_
+#define _BINLOG_H_
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+// Binary structured logging for the hot path.
+//
+// A call site is described once (file, line, format string, argument types)
+// and gets a static id. Each event then only stores the id, a timestamp and
+// the raw arguments into a buffer owned by the calling thread; formatting is
+// done offline by the logdecode tool.
+//
+//     BINLOG("received {} bytes from exchange {}", n, exchange);
+//
+// File layout:
+//     "BINLOG01"
+//     record*  : u32 site_id | u32 body_len | body
+//     site definition (site_id has def_flag set):
+//                u32 line | u16 len, file | u16 len, format | u8 nargs | u8 type * nargs
+//     event    : i64 timestamp (ns since epoch) | args
+//                i64 / u64 / f64 : 8 bytes, blob : u32 len | bytes
+//     events lost (site_id lost_id):
+//                i64 timestamp | u64 events dropped since the last one, their buffer full
+namespace binlog {
+
+constexpr char magic[8] = {'B', 'I', 'N', 'L', 'O', 'G', '0', '1'};
+constexpr uint32_t def_flag = 0x80000000u;
+constexpr uint32_t lost_id = 0x7fffffffu;
+
+enum class arg_type : uint8_t {
+    i64 = 1, u64, f64, blob
+};
+
+// bytes copied into the log as they are, e.g. a raw frame or a serialized message
+struct blob {
+    const void* data;
+    uint32_t size;
+};
+
+struct stats {
+    static inline std::atomic<uint64_t> dropped{0};     // events, their thread buffer full
+};
+
+
+template <typename T>
+constexpr arg_type type_of() {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same_v<U, blob>)
+        return arg_type::blob;
+    else if constexpr (std::is_floating_point_v<U>)
+        return arg_type::f64;
+    else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>)
+        return arg_type::i64;
+    else if constexpr (std::is_integral_v<U> || std::is_enum_v<U>)
+        return arg_type::u64;
+    else
+        static_assert(!sizeof(U), "unsupported binlog argument type");
+}
+
+inline uint32_t arg_size(const blob& b) { return sizeof(uint32_t) + b.size; }
+template <typename T>
+inline uint32_t arg_size(const T&) { return 8; }
+
+
+// Single producer / single consumer byte ring, one per logging thread.
+class thread_buffer {
+public:
+    explicit thread_buffer(size_t capacity) : data_(capacity), mask_(capacity - 1) {}
+
+    // producer
+    bool reserve(uint32_t n) {
+        reserved_ = tail_.load(std::memory_order_relaxed);
+        return reserved_ + n - head_.load(std::memory_order_acquire) <= data_.size();
+    }
+    void put(const void* src, size_t n) {
+        const char* p = static_cast<const char*>(src);
+        size_t offset = reserved_ & mask_;
+        size_t first = std::min(n, data_.size() - offset);
+        std::memcpy(&data_[offset], p, first);
+        std::memcpy(&data_[0], p + first, n - first);
+        reserved_ += n;
+    }
+    void commit() {
+        tail_.store(reserved_, std::memory_order_release);
+    }
+
+    // consumer, copies everything committed so far
+    void drain(std::string& out) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        while (head != tail) {
+            size_t offset = head & mask_;
+            size_t n = std::min(tail - head, data_.size() - offset);
+            out.append(&data_[offset], n);
+            head += n;
+        }
+        head_.store(head, std::memory_order_release);
+    }
+
+    std::atomic<bool> closed{false};
+
+private:
+    std::vector<char> data_;
+    const size_t mask_;
+    size_t reserved_ = 0;
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) std::atomic<size_t> head_{0};
+};
+
+
+struct site {
+    uint32_t id;
+    const char* file;
+    int line;
+    const char* format;
+    std::vector<arg_type> types;
+};
+
+// Process wide state: registered sites and thread buffers.
+class registry {
+public:
+    static registry& instance() {
+        static registry r;
+        return r;
+    }
+
+    uint32_t add_site(const char* file, int line, const char* format, std::vector<arg_type> types) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t id = (uint32_t) sites_.size();
+        sites_.push_back({id, file, line, format, std::move(types)});
+        return id;
+    }
+
+    std::shared_ptr<thread_buffer> add_buffer() {
+        auto buffer = std::make_shared<thread_buffer>(buffer_size);
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffers_.push_back(buffer);
+        return buffer;
+    }
+
+    template <typename F>
+    void for_each_site(size_t from, F&& f) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = from; i < sites_.size(); ++i)
+            f(sites_[i]);
+    }
+
+    std::vector<std::shared_ptr<thread_buffer>> buffers() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return buffers_;
+    }
+
+    // buffers of exited threads are released once drained by the writer
+    void remove_buffer(const std::shared_ptr<thread_buffer>& buffer) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffers_.erase(std::remove(buffers_.begin(), buffers_.end(), buffer), buffers_.end());
+    }
+
+    std::atomic<bool> enabled{false};
+    static constexpr size_t buffer_size = 1 << 20;
+
+private:
+    std::mutex mutex_;
+    std::vector<site> sites_;
+    std::vector<std::shared_ptr<thread_buffer>> buffers_;
+};
+
+inline bool enabled() {
+    return registry::instance().enabled.load(std::memory_order_relaxed);
+}
+
+inline thread_buffer& local_buffer() {
+    struct holder {
+        std::shared_ptr<thread_buffer> buffer = registry::instance().add_buffer();
+        ~holder() { buffer->closed.store(true, std::memory_order_release); }
+    };
+    thread_local holder h;
+    return *h.buffer;
+}
+
+
+inline void put_arg(thread_buffer& b, const blob& v) {
+    b.put(&v.size, sizeof(v.size));
+    b.put(v.data, v.size);
+}
+template <typename T>
+inline void put_arg(thread_buffer& b, const T& v) {
+    if constexpr (type_of<T>() == arg_type::f64) {
+        double d = v;
+        b.put(&d, 8);
+    } else if constexpr (type_of<T>() == arg_type::i64) {
+        int64_t i = v;
+        b.put(&i, 8);
+    } else {
+        uint64_t u = (uint64_t) v;
+        b.put(&u, 8);
+    }
+}
+
+template <typename... Args>
+void write(uint32_t site_id, const Args&... args) {
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    uint32_t body_len = sizeof(now) + (0 + ... + arg_size(args));
+
+    thread_buffer& b = local_buffer();
+    if (!b.reserve(2 * sizeof(uint32_t) + body_len)) {
+        stats::dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    b.put(&site_id, sizeof(site_id));
+    b.put(&body_len, sizeof(body_len));
+    b.put(&now, sizeof(now));
+    (put_arg(b, args), ...);
+    b.commit();
+}
+
+
+// Background writer of the binary log file. Creating it turns binary logging on.
+class writer {
+public:
+    explicit writer(const std::string& filename)
+        : reported_dropped_(stats::dropped.load(std::memory_order_relaxed)) {
+        file_.open(filename + ".binlog", std::ios::out | std::ios::binary | std::ios::trunc);
+        file_.write(magic, sizeof(magic));
+        registry::instance().enabled.store(true, std::memory_order_release);
+        thread_ = std::thread([this] { run(); });
+    }
+
+    ~writer() {
+        registry::instance().enabled.store(false, std::memory_order_release);
+        running_.store(false, std::memory_order_release);
+        if (thread_.joinable()) thread_.join();
+    }
+
+private:
+    void run() {
+        std::string events, out;
+        while (true) {
+            bool running = running_.load(std::memory_order_acquire);
+
+            // drain the events first: a site is always registered before its
+            // first event, so every site seen below is already in the registry
+            events.clear();
+            for (auto& buffer : registry::instance().buffers()) {
+                bool closed = buffer->closed.load(std::memory_order_acquire);
+                buffer->drain(events);
+                if (closed)
+                    registry::instance().remove_buffer(buffer);
+            }
+
+            out.clear();
+            registry::instance().for_each_site(sites_written_, [&] (const site& s) {
+                write_site(s, out);
+                ++sites_written_;
+            });
+            out += events;
+            // the events lost since the last time, after those drained with them
+            uint64_t dropped = stats::dropped.load(std::memory_order_relaxed);
+            if (dropped != reported_dropped_) {
+                write_lost(dropped - reported_dropped_, out);
+                reported_dropped_ = dropped;
+            }
+
+            if (!out.empty()) {
+                file_.write(out.data(), out.size());
+                file_.flush();
+            } else if (!running) {
+                break;
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+
+    static void write_site(const site& s, std::string& out) {
+        auto put = [&] (const void* p, size_t n) { out.append(static_cast<const char*>(p), n); };
+        auto put_str = [&] (const char* str) {
+            uint16_t len = (uint16_t) std::strlen(str);
+            put(&len, sizeof(len));
+            put(str, len);
+        };
+
+        std::string body;
+        std::swap(body, out);
+        uint32_t line = s.line;
+        uint8_t nargs = (uint8_t) s.types.size();
+        put(&line, sizeof(line));
+        put_str(s.file);
+        put_str(s.format);
+        put(&nargs, sizeof(nargs));
+        put(s.types.data(), nargs);
+        std::swap(body, out);
+
+        uint32_t id = s.id | def_flag;
+        uint32_t body_len = (uint32_t) body.size();
+        put(&id, sizeof(id));
+        put(&body_len, sizeof(body_len));
+        out += body;
+    }
+
+    static void write_lost(uint64_t events, std::string& out) {
+        auto put = [&] (const void* p, size_t n) { out.append(static_cast<const char*>(p), n); };
+        int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        uint32_t id = lost_id;
+        uint32_t body_len = sizeof(now) + sizeof(events);
+        put(&id, sizeof(id));
+        put(&body_len, sizeof(body_len));
+        put(&now, sizeof(now));
+        put(&events, sizeof(events));
+    }
+
+    std::ofstream file_;
+    std::atomic<bool> running_{true};
+    std::thread thread_;
+    size_t sites_written_ = 0;
+    uint64_t reported_dropped_;
+};
+
+inline std::unique_ptr<writer> make_writer(const std::string& filename, bool enabled) {
+    return enabled ? std::make_unique<writer>(filename) : nullptr;
+}
+
+}   // namespace binlog
+
+
+// One static site per expansion: each lambda is a distinct type with its own static id.
+#define BINLOG(format, ...) \
+    [] (const auto&... binlog_args) { \
+        static const uint32_t binlog_site = binlog::registry::instance().add_site( \
+            __FILE__, __LINE__, format, {binlog::type_of<decltype(binlog_args)>()...}); \
+        binlog::write(binlog_site, binlog_args...); \
+    }(__VA_ARGS__)
+
+
+#endif // _BINLOG_H_
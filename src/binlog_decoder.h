@@ -0,0 +1,209 @@
+#ifndef _BINLOG_DECODER_H_
+#define _BINLOG_DECODER_H_
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "binlog.h"
+
+
+// Renders a binary log written by binlog::writer as text, for logdecode.
+// The file is not trusted: every field is checked against the end of its
+// record, and a record that does not hold what its site says is reported
+// instead of read past.
+namespace binlog {
+
+struct site_def {
+    uint32_t line;
+    std::string file;
+    std::string format;
+    std::vector<arg_type> types;
+};
+
+// A field past the end fails the reader: it returns zeros from then on and
+// failed() tells.
+class reader {
+public:
+    reader(const char* data, size_t size) : p_(data), end_(data + size) {}
+
+    bool has(size_t n) const { return (size_t) (end_ - p_) >= n; }
+    bool failed() const { return failed_; }
+
+    template <typename T>
+    T get() {
+        T v{};
+        if (!take(sizeof(T)))
+            return v;
+        std::memcpy(&v, p_ - sizeof(T), sizeof(T));
+        return v;
+    }
+
+    std::string get_bytes(size_t n) {
+        if (!take(n))
+            return {};
+        return std::string(p_ - n, n);
+    }
+
+private:
+    bool take(size_t n) {
+        if (failed_ || !has(n)) {
+            failed_ = true;
+            return false;
+        }
+        p_ += n;
+        return true;
+    }
+
+    const char* p_;
+    const char* end_;
+    bool failed_ = false;
+};
+
+inline std::string format_time(int64_t ns) {
+    time_t seconds = ns / 1'000'000'000;
+    struct tm tm;
+    gmtime_r(&seconds, &tm);
+    char buf[64];
+    size_t n = strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", &tm);
+    snprintf(buf + n, sizeof(buf) - n, ".%09lldZ", (long long) (ns % 1'000'000'000));
+    return buf;
+}
+
+inline std::string render_blob(const std::string& bytes) {
+    std::string out;
+    for (unsigned char c : bytes) {
+        if (c >= 0x20 && c < 0x7f) {
+            out += (char) c;
+        } else {
+            char hex[8];
+            snprintf(hex, sizeof(hex), "\\x%02x", c);
+            out += hex;
+        }
+    }
+    return out;
+}
+
+// the arguments of the event in r formatted by its site, r failed if they are not all there
+inline std::string render_event(const site_def& site, reader& r) {
+    std::vector<std::string> args;
+    for (arg_type type : site.types) {
+        switch (type) {
+        case arg_type::i64: args.push_back(std::to_string(r.get<int64_t>())); break;
+        case arg_type::u64: args.push_back(std::to_string(r.get<uint64_t>())); break;
+        case arg_type::f64: {
+            std::ostringstream oss;
+            oss << r.get<double>();
+            args.push_back(oss.str());
+            break;
+        }
+        case arg_type::blob: {
+            uint32_t len = r.get<uint32_t>();
+            args.push_back(render_blob(r.get_bytes(len)));
+            break;
+        }
+        }
+    }
+
+    std::string out;
+    size_t next = 0;
+    const std::string& fmt = site.format;
+    for (size_t i = 0; i < fmt.size(); ++i) {
+        if (fmt[i] == '{' && i + 1 < fmt.size() && fmt[i + 1] == '}') {
+            out += next < args.size() ? args[next++] : "{}";
+            ++i;
+        } else {
+            out += fmt[i];
+        }
+    }
+    return out;
+}
+
+inline bool known_type(uint8_t type) {
+    return type >= (uint8_t) arg_type::i64 && type <= (uint8_t) arg_type::blob;
+}
+
+// Writes one line per event of data, a whole binary log, to out. False with
+// error set if it is not one, or at the first record cut short or corrupt:
+// the lines before it are written.
+inline bool decode(const std::string& data, std::ostream& out, std::string& error) {
+    if (data.size() < sizeof(magic) || std::memcmp(data.data(), magic, sizeof(magic)) != 0) {
+        error = "not a binary log";
+        return false;
+    }
+
+    std::unordered_map<uint32_t, site_def> sites;
+    reader r(data.data() + sizeof(magic), data.size() - sizeof(magic));
+    while (r.has(1)) {
+        uint32_t id = r.get<uint32_t>();
+        uint32_t body_len = r.get<uint32_t>();
+        std::string body = r.get_bytes(body_len);
+        if (r.failed()) {
+            error = "truncated record";
+            return false;
+        }
+        reader b(body.data(), body.size());
+
+        if (id & def_flag) {
+            site_def site;
+            site.line = b.get<uint32_t>();
+            site.file = b.get_bytes(b.get<uint16_t>());
+            site.format = b.get_bytes(b.get<uint16_t>());
+            uint8_t nargs = b.get<uint8_t>();
+            for (uint8_t i = 0; i < nargs; ++i) {
+                uint8_t type = b.get<uint8_t>();
+                if (b.failed())
+                    break;
+                if (!known_type(type)) {
+                    error = "unknown argument type in the definition of site " + std::to_string(id & ~def_flag);
+                    return false;
+                }
+                site.types.push_back((arg_type) type);
+            }
+            if (b.failed()) {
+                error = "corrupt definition of site " + std::to_string(id & ~def_flag);
+                return false;
+            }
+            sites[id & ~def_flag] = std::move(site);
+            continue;
+        }
+
+        int64_t timestamp = b.get<int64_t>();
+        if (id == lost_id) {
+            uint64_t events = b.get<uint64_t>();
+            if (b.failed()) {
+                error = "corrupt record of events lost";
+                return false;
+            }
+            out << format_time(timestamp) << " [WARNING] binlog: dropped " << events << " events\n";
+            continue;
+        }
+        auto it = sites.find(id);
+        if (b.failed()) {
+            error = "corrupt event of site " + std::to_string(id);
+            return false;
+        }
+        if (it == sites.end()) {
+            out << format_time(timestamp) << " [BINLOG] unknown site " << id << "\n";
+            continue;
+        }
+        const site_def& site = it->second;
+        std::string text = render_event(site, b);
+        if (b.failed()) {
+            error = "corrupt event of site " + std::to_string(id);
+            return false;
+        }
+        out << format_time(timestamp) << " [INFO] " << site.file << ":" << site.line << " " << text << "\n";
+    }
+    return true;
+}
+
+}   // namespace binlog
+
+
+#endif // _BINLOG_DECODER_H_
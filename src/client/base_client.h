@@ -2,9 +2,21 @@
 #define __BASE_CLIENT_H__
 
 
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <grpcpp/alarm.h>
 #include <grpcpp/grpcpp.h>
+#include <google/protobuf/arena.h>
 #include "../protos/aggregator.grpc.pb.h"
 #include "../logger.h"
+#include "../binlog.h"
+#include "../wire_codec.h"
+#include "../shm_ring.h"
 
 
 
@@ -12,31 +24,276 @@ using agg_proto::agg_service;
 using agg_proto::tick_request;
 using agg_proto::tick_update;
 using agg_proto::batched_tick_update;
+using agg_proto::analytics_request;
+using agg_proto::analytics_update;
+using agg_proto::wire_encoding;
+using agg_proto::symbol_info;
+using agg_proto::tick_snapshot;
 using grpc::Channel;
 using grpc::ClientContext;
 using grpc::Status;
 
+// updates, compact or delta, as the clients' --encoding flag
+inline bool parse_wire_encoding(const std::string& name, wire_encoding& encoding) {
+    return agg_proto::wire_encoding_Parse("encoding_" + name, &encoding);
+}
+
+// The messages read by base_client live on an arena reset before each read:
+// the updates, and the compact levels Clear() would delete on a reused message
+// (a proto3 submessage), are carved out of one block allocated up front, no
+// heap allocation per message until one outgrows the block.
+class read_arena {
+public:
+    explicit read_arena(size_t block_size = 256 * 1024)
+        : block_(new char[block_size])
+    {
+        google::protobuf::ArenaOptions options;
+        options.initial_block = block_.get();
+        options.initial_block_size = block_size;
+        options.max_block_size = block_size;
+        arena_ = std::make_unique<google::protobuf::Arena>(options);
+    }
+
+    // an empty message, the previous one is gone
+    batched_tick_update* next() {
+        arena_->Reset();
+        return google::protobuf::Arena::CreateMessage<batched_tick_update>(arena_.get());
+    }
+
+private:
+    std::unique_ptr<char[]> block_;
+    std::unique_ptr<google::protobuf::Arena> arena_;
+};
+
+// How base_client subscribes again once a stream has ended, disabled when
+// initial_backoff_ms is 0. The n-th attempt in a row waits between half and
+// all of initial_backoff_ms * 2^(n-1), up to max_backoff_ms: clients cut off
+// together do not come back together.
+struct reconnect_config {
+    int64_t initial_backoff_ms = 0;
+    int64_t max_backoff_ms = 10'000;
+};
+
+struct reconnect_stats {
+    uint64_t reconnects = 0;        // streams subscribed again
+    uint64_t resumed = 0;           // going on from the batches they missed
+    uint64_t snapshots = 0;         // starting over from a snapshot
+    // from the end of a stream to the first batch read on the next one
+    int64_t last_recovery_ns = 0;
+    int64_t max_recovery_ns = 0;
+};
+
+// The client side of the aggregator: any number of subscriptions (tick
+// streams, analytics streams) on one channel, read asynchronously through one
+// completion queue. poll() / poll_non_block() handle the next event, the
+// batches and figures read are dispatched statically to Derived:
+//   void process_ticks(const batched_tick_update &ticks);
+//   void process_analytics(const analytics_update &update);    (optional)
+//   void process_gap(uint64_t from, uint64_t to);                (optional)
+//   void process_reset();                                        (optional)
+// current_subscription() tells which subscription they come from.
+// A subscription can also read the shared memory ring of a server on the
+// same host (subscribe_shm) instead of a gRPC stream.
 template <typename Derived>
 class base_client {
+public:
+    using subscription_id = uint32_t;
+
 private:
+    struct stream;
+
+    // what a completion queue event is about
+    struct event {
+        enum kind_t { started, read, finished, retry };
+        stream* s;
+        kind_t kind;
+    };
+
+    // One server stream, or shared memory ring. The message read lives until
+    // the next read on it.
+    struct stream {
+        explicit stream(subscription_id id) : id(id) {}
+
+        subscription_id id;
+        tick_request request;               // of a tick stream
+        std::vector<std::string> symbols;   // subscribed to, resolved again on each reconnect
+        analytics_request analytics;        // of an analytics stream
+        std::unique_ptr<grpc::ClientContext> context;
+        std::unique_ptr<grpc::ClientAsyncReader<batched_tick_update>> reader;
+        std::unique_ptr<grpc::ClientAsyncReader<analytics_update>> analytics_reader;
+        read_arena arena;
+        batched_tick_update* ticks = nullptr;
+        analytics_update update;
+        grpc::Status status;
+        uint64_t sequence = 0;      // of the last batch of the stream
+        uint64_t published = 0;     // publish_sequence of the last batch, to resume from
+        uint64_t epoch = 0;         // and its publish_epoch
+        grpc::Alarm alarm;          // the next attempt
+        int attempts = 0;           // in a row, without a batch read
+        int64_t ended_ns = 0;       // the stream ended, not recovered yet when > 0
+        uint64_t resumed_from = 0;  // of the stream recovering
+        bool resync = false;        // cancelled after a gap, to start over from a snapshot
+        event on_started{this, event::started};
+        event on_read{this, event::read};
+        event on_finished{this, event::finished};
+        event on_retry{this, event::retry};
+
+        std::string shm_name;                   // of a shared memory subscription
+        std::unique_ptr<shm_ring::reader> shm;  // while attached
+        std::vector<bool> shm_symbols;          // by symbol id, every one if empty
+        std::string shm_message;
+        std::deque<batched_tick_update> snapshot;   // to hand out before the ring
+
+        bool wants(uint32_t symbol_id) const
+        {
+            return shm_symbols.empty() || (symbol_id < shm_symbols.size() && shm_symbols[symbol_id]);
+        }
+    };
+
+    std::string connection_str_;
     std::shared_ptr<Channel> channel_;
     std::unique_ptr<agg_service::Stub> stub_;
-    std::unique_ptr<grpc::ClientContext> context_;
-    std::unique_ptr<grpc::ClientReader<batched_tick_update>> reader_;
+    grpc::CompletionQueue cq_;
+    std::vector<std::unique_ptr<stream>> streams_;
+    subscription_id next_id_ = 0;
+    subscription_id current_ = 0;   // of the event being handled
+    batched_tick_update decoded_;   // a compact batch back as updates, reused
+    std::vector<symbol_info> symbols_;  // by id, as listed by the server
+    uint64_t symbols_epoch_ = 0;        // the publish_epoch of the server that listed them
+    uint64_t gaps_ = 0;
+    reconnect_config reconnect_;
+    reconnect_stats recovery_;
+    std::mt19937 rng_{std::random_device{}()};
+
 public:
     base_client(const std::string& connection_str)
+        : connection_str_(connection_str)
     {
         channel_ = grpc::CreateChannel(connection_str, grpc::InsecureChannelCredentials());
         stub_ = agg_service::NewStub(channel_);
-        context_ = std::make_unique<grpc::ClientContext>();
     }
 
-    void subscribe_symbol(const std::string &symbol)
+    ~base_client()
     {
-        tick_request request;
+        for (auto& s : streams_) {
+            if (s->context)
+                s->context->TryCancel();
+            s->alarm.Cancel();
+        }
+        cq_.Shutdown();
+        void* tag;
+        bool ok;
+        while (cq_.Next(&tag, &ok)) {}
+    }
+
+    subscription_id subscribe_symbol(const std::string &symbol, bool conflate = false, uint32_t depth = 0,
+        wire_encoding encoding = agg_proto::encoding_updates)
+    {
+        return subscribe({symbol}, conflate, depth, encoding);
+    }
+
+    // one stream for several symbols, each batch carries its symbol_id.
+    // The names are resolved with ListSymbols first, by name when the server
+    // cannot.
+    // depth > 0: the consolidated top depth levels per side, in batches of
+    // exchange 0 whose levels carry the quantity of every exchange.
+    // Batches queued on the server are read in one message when behind
+    // (tick_request.coalesce), poll() hands them out one by one.
+    // encoding_compact / encoding_delta: the levels come in fixed point
+    // (wire_codec), the derived client still gets updates.
+    subscription_id subscribe(const std::vector<std::string> &symbols, bool conflate = false, uint32_t depth = 0,
+        wire_encoding encoding = agg_proto::encoding_updates)
+    {
+        stream& s = add_stream();
+        subscription_id id = s.id;
+        s.symbols = symbols;
+        s.request.set_conflate(conflate);
+        s.request.set_depth(depth);
+        s.request.set_coalesce(true);
+        s.request.set_encoding(encoding);
+        resolve(s);
+        start(s);
+        return id;
+    }
+
+    // Every batch of symbols (all of them if empty) from the shared memory
+    // ring of a server on this host (aggregator_server_config::
+    // shm_ring_name), as updates, starting from a snapshot asked over gRPC.
+    // No conflation, depth or encoding there, and no gRPC stream: poll()
+    // spins on the ring instead of waiting for the completion queue. A reader
+    // lapped by the server loses batches: process_gap() and process_reset()
+    // are called, and it starts over from a snapshot.
+    subscription_id subscribe_shm(const std::vector<std::string> &symbols, const std::string &ring)
+    {
+        stream& s = add_stream();
+        subscription_id id = s.id;
+        s.shm_name = ring;
+        for (const auto& symbol : symbols)
+            s.request.add_symbols(symbol);
+        start(s);
+        return id;
+    }
+
+    // The ids of symbols (all of them if empty) with their name, tick size and
+    // lot size, kept for symbol(). False if the server did not answer. Those
+    // kept from a server of another epoch are dropped first.
+    bool list_symbols(const std::vector<std::string> &symbols = {})
+    {
+        agg_proto::symbol_list_request request;
+        for (const auto& symbol : symbols)
+            request.add_symbols(symbol);
+        agg_proto::symbol_list reply;
+        grpc::ClientContext context;
+        context.set_deadline(std::chrono::system_clock::now() + std::chrono::seconds(5));
+        grpc::Status status = stub_->ListSymbols(&context, request, &reply);
+        if (!status.ok()) {
+            LOG(WARNING) << "ListSymbols failed: " << status.error_message();
+            return false;
+        }
+        if (reply.publish_epoch() != symbols_epoch_) {
+            symbols_.clear();
+            symbols_epoch_ = reply.publish_epoch();
+        }
+        for (const auto& info : reply.symbols()) {
+            if (info.id() >= symbols_.size())
+                symbols_.resize(info.id() + 1);
+            symbols_[info.id()] = info;
+        }
+        return true;
+    }
+
+    // the symbol of a batch, nullptr if not listed
+    const symbol_info* symbol(uint32_t symbol_id) const
+    {
+        if (symbol_id >= symbols_.size() || symbols_[symbol_id].name().empty())
+            return nullptr;
+        return &symbols_[symbol_id];
+    }
+
+    const symbol_info* find_symbol(const std::string &name) const
+    {
+        for (const auto& info : symbols_)
+            if (info.name() == name)
+                return &info;
+        return nullptr;
+    }
+
+    // the figures computed by the server instead of the ticks: best bid / ask,
+    // plus the volume and price bands asked for
+    subscription_id subscribe_analytics(const std::string &symbol, const std::vector<double> &volume_bands = {},
+        const std::vector<int> &price_bands = {})
+    {
+        analytics_request request;
         request.set_symbol(symbol);
-        reader_ = stub_->TickBatchedStreamRequest(context_.get(), request);
-        LOG(INFO) << "Sent:" << request.ShortDebugString();
+        for (double band : volume_bands)
+            request.add_volume_bands(band);
+        for (int bps : price_bands)
+            request.add_price_bands(bps);
+        stream& s = add_stream();
+        subscription_id id = s.id;
+        s.analytics = request;
+        start(s);
+        return id;
     }
 
     //virtual void process_ticks(const batched_tick_update &ticks) = 0;
@@ -45,27 +302,471 @@ public:
         static_cast<Derived*>(this)->process_ticks(ticks); // Calls the derived class's implementation
     }
 
+    // a client subscribing to analytics implements it
+    void process_analytics(const analytics_update &update) {}
+
+    // The batches from sequence from to to - 1 of the stream are lost: the
+    // server dropped them for a client too slow (drop_oldest). The stream is
+    // then subscribed again from a snapshot, process_reset() is called first.
+    void process_gap(uint64_t from, uint64_t to) {}
+
+    // The stream subscribed again starts over from a snapshot instead of the
+    // batches it missed: what was built from it must be dropped first.
+    void process_reset() {}
+
+    // Streams ending, other than refused (a bad request), are subscribed
+    // again, resuming from the last batch read (tick_request.resume_from).
+    // Called before subscribing: the channel is made again with the same
+    // backoff, otherwise gRPC's own (1 s, then growing) delays the attempts
+    // while the server is down.
+    void set_reconnect(const reconnect_config& config)
+    {
+        reconnect_ = config;
+        if (config.initial_backoff_ms == 0)
+            return;
+        grpc::ChannelArguments args;
+        args.SetInt(GRPC_ARG_INITIAL_RECONNECT_BACKOFF_MS, config.initial_backoff_ms);
+        args.SetInt(GRPC_ARG_MIN_RECONNECT_BACKOFF_MS, config.initial_backoff_ms);
+        args.SetInt(GRPC_ARG_MAX_RECONNECT_BACKOFF_MS, std::max(config.max_backoff_ms, config.initial_backoff_ms));
+        channel_ = grpc::CreateCustomChannel(connection_str_, grpc::InsecureChannelCredentials(), args);
+        stub_ = agg_service::NewStub(channel_);
+    }
+
+    const reconnect_stats& recovery() const { return recovery_; }
+
+    // the subscription of the batch, figures or gap being processed
+    subscription_id current_subscription() const { return current_; }
+
+    // subscriptions whose stream has not ended
+    size_t subscriptions() const { return streams_.size(); }
+
+    // gaps seen over every stream
+    uint64_t gaps() const { return gaps_; }
+
+    // where a subscription would resume from, 0 for a snapshot
+    uint64_t published(subscription_id id) const
+    {
+        const stream* s = find(id);
+        return s ? s->published : 0;
+    }
+
+    // Waits for the next event of the subscriptions and handles it. False
+    // once no subscription is left.
     bool poll()
     {
-        if (!reader_)
+        return poll(gpr_inf_future(GPR_CLOCK_MONOTONIC));
+    }
+
+    // handles the next event if there is one already, false otherwise
+    bool poll_non_block()
+    {
+        return poll(gpr_inf_past(GPR_CLOCK_MONOTONIC));
+    }
+
+    // false if no event came before deadline
+    template <typename Deadline>
+    bool poll(const Deadline& deadline)
+    {
+        if (streams_.empty())
             return false;
-        batched_tick_update ticks;
-        if (reader_->Read(&ticks))
-        {
-            LOG(INFO) << "Received:" << ticks.ShortDebugString();
-            process_ticks(ticks);
-            return true;
+        if (!reading_shm())
+            return next_event(deadline);
+        // nothing to wait on for a ring: read in turn with the queue
+        gpr_timespec until = gpr_convert_clock_type(grpc::TimePoint<Deadline>(deadline).raw_time(), GPR_CLOCK_MONOTONIC);
+        do {
+            if (poll_shm() || next_event(gpr_inf_past(GPR_CLOCK_MONOTONIC)))
+                return true;
+        } while (!streams_.empty() && gpr_time_cmp(gpr_now(GPR_CLOCK_MONOTONIC), until) < 0);
+        return false;
+    }
+
+private:
+    stream& add_stream()
+    {
+        streams_.push_back(std::make_unique<stream>(next_id_++));
+        return *streams_.back();
+    }
+
+    template <typename Deadline>
+    bool next_event(const Deadline& deadline)
+    {
+        void* tag;
+        bool ok;
+        if (cq_.AsyncNext(&tag, &ok, deadline) != grpc::CompletionQueue::GOT_EVENT)
+            return false;
+        handle(*static_cast<event*>(tag), ok);
+        return true;
+    }
+
+    // The symbols of s by their id, by name when the server cannot list
+    // them. Again on each reconnect: a server restarted under another
+    // configuration has other ids.
+    void resolve(stream& s)
+    {
+        if (s.symbols.empty())
+            return;
+        bool listed = list_symbols(s.symbols);
+        s.request.clear_symbols();
+        s.request.clear_symbol_ids();
+        for (const auto& symbol : s.symbols) {
+            const symbol_info* info = listed ? find_symbol(symbol) : nullptr;
+            if (info)
+                s.request.add_symbol_ids(info->id());
+            else
+                s.request.add_symbols(symbol);
         }
-        else
-        {
-            grpc::Status status = reader_->Finish();
-            reader_.reset();
+    }
+
+    // s may be gone when it could not start
+    void start(stream& s)
+    {
+        if (!s.shm_name.empty()) {
+            start_shm(s);
+            return;
+        }
+        s.context = std::make_unique<grpc::ClientContext>();
+        if (s.analytics.symbol().empty()) {
+            s.reader = stub_->PrepareAsyncTickBatchedStreamRequest(s.context.get(), s.request, &cq_);
+            s.reader->StartCall(&s.on_started);
+            LOG(INFO) << "Sent:" << s.request.ShortDebugString();
+        } else {
+            s.analytics_reader = stub_->PrepareAsyncAnalyticsStreamRequest(s.context.get(), s.analytics, &cq_);
+            s.analytics_reader->StartCall(&s.on_started);
+            LOG(INFO) << "Sent:" << s.analytics.ShortDebugString();
+        }
+    }
+
+    static int64_t now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // a stream refused stays down
+    bool should_reconnect(const grpc::Status& status) const
+    {
+        return reconnect_.initial_backoff_ms > 0 &&
+            status.error_code() != grpc::StatusCode::INVALID_ARGUMENT &&
+            status.error_code() != grpc::StatusCode::UNIMPLEMENTED;
+    }
+
+    void schedule_retry(stream& s)
+    {
+        int64_t backoff = reconnect_.initial_backoff_ms << std::min(s.attempts, 20);
+        backoff = std::min(backoff, std::max(reconnect_.max_backoff_ms, reconnect_.initial_backoff_ms));
+        int64_t delay = std::uniform_int_distribution<int64_t>(backoff / 2, backoff)(rng_);
+        ++s.attempts;
+        if (s.ended_ns == 0)
+            s.ended_ns = now_ns();
+        LOG(INFO) << "stream " << s.id << " subscribing again in " << delay << " ms (attempt " << s.attempts << ")";
+        s.alarm.Set(&cq_, std::chrono::system_clock::now() + std::chrono::milliseconds(delay), &s.on_retry);
+    }
+
+    void retry(stream& s)
+    {
+        s.reader.reset();
+        s.analytics_reader.reset();
+        s.status = grpc::Status();
+        s.sequence = 0;
+        ++recovery_.reconnects;
+        if (s.analytics.symbol().empty()) {
+            s.request.set_resume_from(s.published);
+            s.request.set_resume_epoch(s.epoch);
+            s.resumed_from = s.published;
+            // nothing to resume from (a depth stream, or no batch read yet)
+            if (s.published == 0)
+                static_cast<Derived*>(this)->process_reset();
+            resolve(s);
+        }
+        start(s);
+    }
+
+    bool reading_shm() const
+    {
+        for (const auto& s : streams_)
+            if (s->shm)
+                return true;
+        return false;
+    }
+
+    // Attaches the ring then asks for the snapshot, and reads on from the
+    // batch after the last one in it (tick_snapshot.publish_sequence: the
+    // server numbers the batches of the ring the same way).
+    void start_shm(stream& s)
+    {
+        auto reader = std::make_unique<shm_ring::reader>();
+        std::vector<std::string> names(s.request.symbols().begin(), s.request.symbols().end());
+        bool attached = reader->open(s.shm_name) && (names.empty() || list_symbols(names));
+        s.shm_symbols.clear();
+        for (const auto& name : names) {
+            const symbol_info* info = attached ? find_symbol(name) : nullptr;
+            if (!info) {
+                attached = false;
+                break;
+            }
+            if (info->id() >= s.shm_symbols.size())
+                s.shm_symbols.resize(info->id() + 1);
+            s.shm_symbols[info->id()] = true;
+        }
+        if (!attached || !request_snapshot(s, *reader)) {
+            s.status = grpc::Status(grpc::StatusCode::UNAVAILABLE, "shared memory ring " + s.shm_name + " not attached");
+            ended(s);
+            return;
+        }
+        LOG(INFO) << "stream " << s.id << " reading shared memory ring " << s.shm_name << " from batch " << reader->next();
+        s.shm = std::move(reader);
+    }
+
+    // Without the position of a snapshot, from a server not numbering its
+    // batches or missing a symbol, the reader starts from the oldest batch in
+    // the ring: a batch already in a book is applied again, the book is the
+    // same once the batches after it are.
+    bool request_snapshot(stream& s, shm_ring::reader& reader)
+    {
+        s.snapshot.clear();
+        uint64_t from = UINT64_MAX;
+        std::vector<std::string> names(s.request.symbols().begin(), s.request.symbols().end());
+        if (names.empty())
+            names.emplace_back();   // every symbol
+        for (const auto& name : names) {
+            tick_request request;
+            request.set_symbol(name);
+            tick_snapshot reply;
+            grpc::ClientContext context;
+            context.set_deadline(std::chrono::system_clock::now() + std::chrono::seconds(5));
+            grpc::Status status = stub_->TickSnapshotRequest(&context, request, &reply);
+            // a symbol without any batch yet
+            if (status.error_code() == grpc::StatusCode::NOT_FOUND) {
+                from = 0;
+                continue;
+            }
+            if (!status.ok()) {
+                LOG(WARNING) << "TickSnapshotRequest failed: " << status.error_message();
+                return false;
+            }
+            from = std::min<uint64_t>(from, reply.publish_sequence());
+            for (auto& ticks : *reply.mutable_books())
+                s.snapshot.push_back(std::move(ticks));
+        }
+        reader.seek(from == 0 ? reader.oldest() : from + 1);
+        return true;
+    }
+
+    // One batch of the shared memory subscriptions, false if none has any.
+    bool poll_shm()
+    {
+        for (size_t i = 0; i < streams_.size(); ++i) {
+            stream& s = *streams_[i];
+            if (!s.shm)
+                continue;
+            current_ = s.id;
+            if (!s.snapshot.empty()) {
+                receive(s, s.snapshot.front());
+                s.snapshot.pop_front();
+                return true;
+            }
+            uint64_t lost = 0;
+            while (true) {
+                shm_ring::read_result result = s.shm->read(s.shm_message, lost);
+                if (result == shm_ring::read_result::none)
+                    break;
+                if (result == shm_ring::read_result::closed) {
+                    s.shm.reset();
+                    s.status = grpc::Status(grpc::StatusCode::UNAVAILABLE, "shared memory ring " + s.shm_name + " closed");
+                    ended(s);
+                    return true;
+                }
+                if (result == shm_ring::read_result::overrun) {
+                    missed(s, lost, "lapped by the shared memory ring");
+                    return true;
+                }
+                if (result == shm_ring::read_result::dropped) {
+                    missed(s, lost, "too large for the shared memory ring");
+                    return true;
+                }
+                s.ticks = s.arena.next();
+                if (!s.ticks->ParseFromString(s.shm_message) || !s.wants(s.ticks->symbol_id()))
+                    continue;
+                receive(s, *s.ticks);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // the lost batches before the next one of the ring, why: starts over
+    // from a snapshot
+    void missed(stream& s, uint64_t lost, const char* why)
+    {
+        uint64_t to = s.shm->next();
+        ++gaps_;
+        LOG(WARNING) << "stream " << s.id << " " << why << ": batches " << to - lost << " to " << to - 1 << " lost";
+        static_cast<Derived*>(this)->process_gap(to - lost, to);
+        static_cast<Derived*>(this)->process_reset();
+        if (!request_snapshot(s, *s.shm)) {
+            s.shm.reset();
+            s.status = grpc::Status(grpc::StatusCode::UNAVAILABLE, "no snapshot after shared memory ring " + s.shm_name);
+            ended(s);
+        }
+    }
+
+    // The first batch after a reconnect (nullptr for analytics): a batch
+    // replayed, or a snapshot when the server could not resume. Not
+    // necessarily the one after the last batch read: the sequence counts the
+    // batches of every symbol, those of the other symbols are not replayed.
+    // A server restarted numbers its batches from 1 again, under another
+    // epoch.
+    void recovered(stream& s, const batched_tick_update* ticks)
+    {
+        if (s.resumed_from != 0) {
+            if (ticks->flag() != (uint64_t) updata_flag_t::snapshot && ticks->publish_epoch() == s.epoch &&
+                ticks->publish_sequence() > s.resumed_from) {
+                ++recovery_.resumed;
+            } else {
+                ++recovery_.snapshots;
+                static_cast<Derived*>(this)->process_reset();
+            }
+        } else if (ticks) {
+            ++recovery_.snapshots;
+        }
+        int64_t recovery = now_ns() - s.ended_ns;
+        recovery_.last_recovery_ns = recovery;
+        recovery_.max_recovery_ns = std::max(recovery_.max_recovery_ns, recovery);
+        LOG(INFO) << "stream " << s.id << " recovered in " << recovery / 1'000'000 << " ms";
+        s.ended_ns = 0;
+        s.resumed_from = 0;
+        s.attempts = 0;
+    }
+
+    const stream* find(subscription_id id) const
+    {
+        for (const auto& s : streams_)
+            if (s->id == id)
+                return s.get();
+        return nullptr;
+    }
+
+    // subscribed again later, or gone
+    void ended(stream& s)
+    {
+        LOG(INFO) << "stream " << s.id << " ended: " << s.status.error_code() << " " << s.status.error_message();
+        if (s.resync) {
+            s.resync = false;
+            retry(s);
+            return;
+        }
+        if (should_reconnect(s.status)) {
+            schedule_retry(s);
+            return;
+        }
+        streams_.erase(std::find_if(streams_.begin(), streams_.end(),
+            [&] (const std::unique_ptr<stream>& p) { return p.get() == &s; }));
+    }
+
+    void handle(const event& e, bool ok)
+    {
+        stream& s = *e.s;
+        current_ = s.id;
+        if (e.kind == event::retry) {
+            if (ok)
+                retry(s);
+            return;
+        }
+        if (e.kind == event::finished) {
+            ended(s);
+            return;
+        }
+        if (!ok) {
+            // the stream is over, or could not start
+            if (s.reader)
+                s.reader->Finish(&s.status, &s.on_finished);
+            else
+                s.analytics_reader->Finish(&s.status, &s.on_finished);
+            return;
+        }
+        if (e.kind == event::read) {
+            if (s.reader)
+                receive_message(s);
+            else
+                receive_analytics(s);
+        }
+        // the next read
+        if (s.reader) {
+            s.ticks = s.arena.next();
+            s.reader->Read(s.ticks, &s.on_read);
+        } else {
+            s.analytics_reader->Read(&s.update, &s.on_read);
+        }
+    }
+
+    void receive_message(stream& s)
+    {
+        if (s.ticks->batches_size() == 0)
+            receive(s, *s.ticks);
+        for (const auto& batch : s.ticks->batches())
+            receive(s, batch);
+    }
+
+    void receive(stream& s, const batched_tick_update &ticks)
+    {
+        // the rest of a stream cancelled after a gap
+        if (s.resync)
+            return;
+        if (s.ended_ns != 0)
+            recovered(s, &ticks);
+        if (!check_sequence(s, ticks.sequence()))
+            return;
+        if (ticks.publish_sequence() != 0) {
+            s.published = ticks.publish_sequence();
+            s.epoch = ticks.publish_epoch();
+        }
+        if (ticks.has_levels()) {
+            wire_codec::decode(ticks, decoded_);
+            dispatch(decoded_);
+        } else {
+            dispatch(ticks);
+        }
+    }
+
+    // False after a gap: the stream is cancelled and subscribed again once
+    // it has ended, without resume_from, so that it starts over from a
+    // snapshot as a lapped shared memory reader does. A server without
+    // sequence numbers sends 0.
+    bool check_sequence(stream& s, uint64_t sequence)
+    {
+        if (sequence == 0)
+            return true;
+        if (s.sequence != 0 && sequence != s.sequence + 1) {
+            ++gaps_;
+            LOG(WARNING) << "stream " << s.id << " gap: batches " << s.sequence + 1 << " to " << sequence - 1 << " lost";
+            static_cast<Derived*>(this)->process_gap(s.sequence + 1, sequence);
+            s.resync = true;
+            s.published = 0;
+            s.ended_ns = now_ns();
+            s.context->TryCancel();
             return false;
         }
+        s.sequence = sequence;
         return true;
     }
 
+    void dispatch(const batched_tick_update &ticks)
+    {
+        if (binlog::enabled())
+            BINLOG("Received: exchange {} tick_id {} flag {} updates {}",
+                ticks.exchange(), ticks.tick_id(), ticks.flag(), ticks.updates_size());
+        else
+            LOG_RATE_LIMITED(INFO, hot_path_log_rate) << "Received:" << ticks.ShortDebugString();
+        process_ticks(ticks);
+    }
 
+    void receive_analytics(stream& s)
+    {
+        if (s.ended_ns != 0)
+            recovered(s, nullptr);
+        LOG_RATE_LIMITED(INFO, hot_path_log_rate) << "Received:" << s.update.ShortDebugString();
+        static_cast<Derived*>(this)->process_analytics(s.update);
+    }
 
 };
 
@@ -5,6 +5,7 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <thread>
 
 #include "absl/flags/flag.h"
 #include "absl/flags/parse.h"
@@ -14,8 +15,20 @@
 #include "base_client.h"
 #include "orderbook.h"
 #include "../logger.h"
+#include "../binlog.h"
+#include "../shm_bbo.h"
 
 ABSL_FLAG(std::string, target, "localhost:50051", "Server address");
+ABSL_FLAG(bool, async_log, true, "Write the log file from a background thread");
+ABSL_FLAG(bool, binary_log, false, "Log the hot path in binary to <name>.binlog, read it with logdecode");
+ABSL_FLAG(bool, conflate, false, "Ask the server for the latest state per level instead of every batch when behind");
+ABSL_FLAG(std::string, encoding, "updates", "Levels as updates, compact (fixed point) or delta (fixed point, prices as deltas in ticks)");
+ABSL_FLAG(bool, server_analytics, false, "Subscribe to the figures computed by the server instead of the ticks");
+ABSL_FLAG(uint32_t, depth, 0, "Subscribe to the consolidated top N levels instead of the exchange batches, 1 is enough here");
+ABSL_FLAG(int64_t, reconnect_ms, 100, "First wait before subscribing again once the stream has ended, doubling up to --reconnect_max_ms, 0: exit instead");
+ABSL_FLAG(int64_t, reconnect_max_ms, 10000, "Longest wait before subscribing again");
+ABSL_FLAG(std::string, shm_ring, "", "Read the batches from this shared memory ring of a server on the same host (busy polling it) instead of a gRPC stream");
+ABSL_FLAG(std::string, shm_bbo, "", "Read the best bid / ask from this shared memory table of a server on the same host (busy polling it) instead of keeping a book");
 
 using agg_proto::batched_tick_update;
 using namespace order_book;
@@ -32,10 +45,41 @@ public:
     void process_ticks(const batched_tick_update &ticks)
     {
         book_.update_ticks(ticks);
+        show(book_.best_bid(), book_.best_ask());
+    }
+
+    // subscribed again, from a snapshot
+    void process_reset()
+    {
+        book_ = extended_book();
+    }
+
+    void process_analytics(const analytics_update &update)
+    {
+        tick_data bb = {};
+        bb.price = update.best_bid();
+        bb.qty[0] = update.best_bid_quantity();
+        tick_data ba = {};
+        ba.price = update.best_ask();
+        ba.qty[0] = update.best_ask_quantity();
+        show(bb, ba);
+    }
 
-        auto bb = book_.best_bid();
-        auto ba = book_.best_ask();
+    // the best bid / ask of the server's shared memory table
+    void process_bbo(const shm_bbo::quote &q)
+    {
+        tick_data bb = {};
+        bb.price = q.bid.price;
+        std::copy(std::begin(q.bid.qty), std::end(q.bid.qty), bb.qty);
+        tick_data ba = {};
+        ba.price = q.ask.price;
+        std::copy(std::begin(q.ask.qty), std::end(q.ask.qty), ba.qty);
+        show(bb, ba);
+    }
 
+private:
+    void show(const tick_data& bb, const tick_data& ba)
+    {
         bool print = false;
         int x = 0;
         if (!is_equal(bb.price, best_bid_.price)) {
@@ -61,27 +105,62 @@ public:
         best_ask_ = ba;
     }
 
-private:
     extended_book book_;
     tick_data best_bid_;
     tick_data best_ask_;
 };
 
+// polls the entry of symbol in the table until the server is gone
+int read_bbo(bbo_client& client, const std::string& table, const std::string& symbol)
+{
+    shm_bbo::reader reader;
+    if (!reader.open(table))
+        return 1;
+    int64_t index;
+    while ((index = reader.find(symbol)) < 0) {
+        if (reader.closed())
+            return 0;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    uint64_t last = 0;
+    shm_bbo::quote q;
+    while (!reader.closed()) {
+        uint64_t sequence;
+        if (reader.sequence(index) != last && reader.read(index, q, sequence)) {
+            last = sequence;
+            client.process_bbo(q);
+        }
+    }
+    return 0;
+}
+
 int main(int argc, char **argv)
 {
     absl::ParseCommandLine(argc, argv);
     absl::InitializeLog();
-    file_log_sink logger("client1");
+    auto logger = make_log_sink("client1", absl::GetFlag(FLAGS_async_log));
+    auto binary_logger = binlog::make_writer("client1", absl::GetFlag(FLAGS_binary_log));
 
+    wire_encoding encoding;
+    if (!parse_wire_encoding(absl::GetFlag(FLAGS_encoding), encoding)) {
+        LOG(ERROR) << "unknown encoding " << absl::GetFlag(FLAGS_encoding);
+        return 1;
+    }
     std::string connection_str = absl::GetFlag(FLAGS_target);
 
     bbo_client client(connection_str);
-    client.subscribe_symbol("BTCUSDT");
-
-    while (true)
-    {
-        bool got_message = client.poll();
-    }
+    if (!absl::GetFlag(FLAGS_shm_bbo).empty())
+        return read_bbo(client, absl::GetFlag(FLAGS_shm_bbo), "BTCUSDT");
+    client.set_reconnect({absl::GetFlag(FLAGS_reconnect_ms), absl::GetFlag(FLAGS_reconnect_max_ms)});
+    if (!absl::GetFlag(FLAGS_shm_ring).empty())
+        client.subscribe_shm({"BTCUSDT"}, absl::GetFlag(FLAGS_shm_ring));
+    else if (absl::GetFlag(FLAGS_server_analytics))
+        client.subscribe_analytics("BTCUSDT");
+    else
+        client.subscribe_symbol("BTCUSDT", absl::GetFlag(FLAGS_conflate), absl::GetFlag(FLAGS_depth), encoding);
+
+    // waits for the stream, false once it has ended for good
+    while (client.poll()) {}
 
     return 0;
 }
@@ -14,8 +14,17 @@
 #include "base_client.h"
 #include "orderbook.h"
 #include "../logger.h"
+#include "../binlog.h"
 
 ABSL_FLAG(std::string, target, "localhost:50051", "Server address");
+ABSL_FLAG(bool, async_log, true, "Write the log file from a background thread");
+ABSL_FLAG(bool, binary_log, false, "Log the hot path in binary to <name>.binlog, read it with logdecode");
+ABSL_FLAG(bool, conflate, false, "Ask the server for the latest state per level instead of every batch when behind");
+ABSL_FLAG(std::string, encoding, "updates", "Levels as updates, compact (fixed point) or delta (fixed point, prices as deltas in ticks)");
+ABSL_FLAG(bool, server_analytics, false, "Subscribe to the figures computed by the server instead of the ticks");
+ABSL_FLAG(int64_t, reconnect_ms, 100, "First wait before subscribing again once the stream has ended, doubling up to --reconnect_max_ms, 0: exit instead");
+ABSL_FLAG(int64_t, reconnect_max_ms, 10000, "Longest wait before subscribing again");
+ABSL_FLAG(std::string, shm_ring, "", "Read the batches from this shared memory ring of a server on the same host (busy polling it) instead of a gRPC stream");
 
 using agg_proto::batched_tick_update;
 using namespace order_book;
@@ -34,9 +43,24 @@ public:
     void process_ticks(const batched_tick_update &ticks)
     {
         book_.update_ticks(ticks);
-        auto bids = book_.volume_band_bids(bands_ );
-        auto asks = book_.volume_band_asks(bands_ );
+        show(book_.volume_band_bids(bands_ ), book_.volume_band_asks(bands_ ));
+    }
+
+    // subscribed again, from a snapshot
+    void process_reset()
+    {
+        book_ = extended_book();
+    }
+
+    void process_analytics(const analytics_update &update)
+    {
+        show({update.bid_volume_bands().begin(), update.bid_volume_bands().end()},
+             {update.ask_volume_bands().begin(), update.ask_volume_bands().end()});
+    }
 
+private:
+    void show(const std::vector<double>& bids, const std::vector<double>& asks)
+    {
         for (auto p : bids) {
             double f = p;
             printf("%f ", f);
@@ -50,7 +74,6 @@ public:
         fflush(stdout);
     }
 
-private:
     extended_book book_;
     std::vector<double> bands_;
 };
@@ -59,19 +82,29 @@ int main(int argc, char **argv)
 {
     absl::ParseCommandLine(argc, argv);
     absl::InitializeLog();
-    file_log_sink logger("client2");
+    auto logger = make_log_sink("client2", absl::GetFlag(FLAGS_async_log));
+    auto binary_logger = binlog::make_writer("client2", absl::GetFlag(FLAGS_binary_log));
 
+    wire_encoding encoding;
+    if (!parse_wire_encoding(absl::GetFlag(FLAGS_encoding), encoding)) {
+        LOG(ERROR) << "unknown encoding " << absl::GetFlag(FLAGS_encoding);
+        return 1;
+    }
     std::string connection_str = absl::GetFlag(FLAGS_target);
 
     std::vector<double> bands =  { 1'000'000, 5'000'000, 10'000'000, 25'000'000, 50'000'000} ;
 
     vb_client client(connection_str, bands);
-    client.subscribe_symbol("BTCUSDT");
-
-    while (true)
-    {
-        bool got_message = client.poll();
-    }
+    client.set_reconnect({absl::GetFlag(FLAGS_reconnect_ms), absl::GetFlag(FLAGS_reconnect_max_ms)});
+    if (!absl::GetFlag(FLAGS_shm_ring).empty())
+        client.subscribe_shm({"BTCUSDT"}, absl::GetFlag(FLAGS_shm_ring));
+    else if (absl::GetFlag(FLAGS_server_analytics))
+        client.subscribe_analytics("BTCUSDT", bands);
+    else
+        client.subscribe_symbol("BTCUSDT", absl::GetFlag(FLAGS_conflate), 0, encoding);
+
+    // waits for the stream, false once it has ended for good
+    while (client.poll()) {}
 
     return 0;
 }
@@ -14,8 +14,18 @@
 #include "base_client.h"
 #include "orderbook.h"
 #include "../logger.h"
+#include "../binlog.h"
 
 ABSL_FLAG(std::string, target, "localhost:50051", "Server address");
+ABSL_FLAG(bool, async_log, true, "Write the log file from a background thread");
+ABSL_FLAG(bool, binary_log, false, "Log the hot path in binary to <name>.binlog, read it with logdecode");
+ABSL_FLAG(bool, conflate, false, "Ask the server for the latest state per level instead of every batch when behind");
+ABSL_FLAG(std::string, encoding, "updates", "Levels as updates, compact (fixed point) or delta (fixed point, prices as deltas in ticks)");
+ABSL_FLAG(bool, server_analytics, false, "Subscribe to the figures computed by the server instead of the ticks");
+ABSL_FLAG(uint32_t, depth, 0, "Subscribe to the consolidated top N levels instead of the exchange batches, 1 is enough here");
+ABSL_FLAG(int64_t, reconnect_ms, 100, "First wait before subscribing again once the stream has ended, doubling up to --reconnect_max_ms, 0: exit instead");
+ABSL_FLAG(int64_t, reconnect_max_ms, 10000, "Longest wait before subscribing again");
+ABSL_FLAG(std::string, shm_ring, "", "Read the batches from this shared memory ring of a server on the same host (busy polling it) instead of a gRPC stream");
 
 using agg_proto::batched_tick_update;
 using namespace order_book;
@@ -45,29 +55,47 @@ public:
         auto ba = book_.best_ask().price;
 
         if (!is_equal(best_bid_, bb) || !is_equal(best_ask_, ba))
-        {
-
-            auto bids = book_.price_band(bb, bps_);
-            auto asks = book_.price_band(ba, bps_);
-
-            for (auto& i : bids) {
-                printf("%f ", i );
-            }
-            printf(" | ");
-            for (auto& i : asks) {
-                printf("%f ", i );
-            }
-            printf("\n");
-            fflush(stdout);
-        }
+            show(book_.price_band(bb, bps_), book_.price_band(ba, bps_));
 
         return;
     }
 
+    // subscribed again, from a snapshot
+    void process_reset()
+    {
+        book_ = extended_book();
+        best_bid_ = 0;
+        best_ask_ = 0;
+    }
+
+    void process_analytics(const analytics_update &update)
+    {
+        // also sent when only a quantity changed
+        if (is_equal(best_bid_, update.best_bid()) && is_equal(best_ask_, update.best_ask()))
+            return;
+        best_bid_ = update.best_bid();
+        best_ask_ = update.best_ask();
+        show({update.bid_price_bands().begin(), update.bid_price_bands().end()},
+             {update.ask_price_bands().begin(), update.ask_price_bands().end()});
+    }
+
 private:
+    void show(const std::vector<double>& bids, const std::vector<double>& asks)
+    {
+        for (auto& i : bids) {
+            printf("%f ", i );
+        }
+        printf(" | ");
+        for (auto& i : asks) {
+            printf("%f ", i );
+        }
+        printf("\n");
+        fflush(stdout);
+    }
+
     extended_book book_;
-    double best_bid_;
-    double best_ask_;
+    double best_bid_ = 0;
+    double best_ask_ = 0;
     std::vector<int> bps_;
 };
 
@@ -75,19 +103,29 @@ int main(int argc, char **argv)
 {
     absl::ParseCommandLine(argc, argv);
     absl::InitializeLog();
-    file_log_sink logger("client3");
+    auto logger = make_log_sink("client3", absl::GetFlag(FLAGS_async_log));
+    auto binary_logger = binlog::make_writer("client3", absl::GetFlag(FLAGS_binary_log));
 
+    wire_encoding encoding;
+    if (!parse_wire_encoding(absl::GetFlag(FLAGS_encoding), encoding)) {
+        LOG(ERROR) << "unknown encoding " << absl::GetFlag(FLAGS_encoding);
+        return 1;
+    }
     std::string connection_str = absl::GetFlag(FLAGS_target);
 
     std::vector<int> bps = { 0, 50, 100, 200, 500, 1000};
 
     pb_client client(connection_str, bps);
-    client.subscribe_symbol("BTCUSDT");
-
-    while (true)
-    {
-        bool got_message = client.poll();
-    }
+    client.set_reconnect({absl::GetFlag(FLAGS_reconnect_ms), absl::GetFlag(FLAGS_reconnect_max_ms)});
+    if (!absl::GetFlag(FLAGS_shm_ring).empty())
+        client.subscribe_shm({"BTCUSDT"}, absl::GetFlag(FLAGS_shm_ring));
+    else if (absl::GetFlag(FLAGS_server_analytics))
+        client.subscribe_analytics("BTCUSDT", {}, bps);
+    else
+        client.subscribe_symbol("BTCUSDT", absl::GetFlag(FLAGS_conflate), absl::GetFlag(FLAGS_depth), encoding);
+
+    // waits for the stream, false once it has ended for good
+    while (client.poll()) {}
 
     return 0;
 }
@@ -15,7 +15,6 @@ using agg_proto::batched_tick_update;
 namespace order_book {
 
 
-    constexpr int fixed_price_scale = 1'000'000; // 4 d.p.
     #define to_fixed_price(d) (static_cast<int64_t>(d * fixed_price_scale));
     #define fr_fixed_price(f) (static_cast<double>(f) / fixed_price_scale);
     constexpr double price_max = std::numeric_limits<double>::max();
@@ -71,6 +70,22 @@ struct sided_book {
         }
     }
 
+    // a level of a consolidated depth stream replaces the whole level
+    void update_consolidated(const tick_update& tick) {
+        int64_t key = to_fixed_price(tick.price());
+        if (!is_greater(tick.quantity(), 0)) {
+            book_.erase(key);
+            return;
+        }
+        tick_data& level = book_[key];
+        level = {};
+        level.price = tick.price();
+        level.qty[0] = tick.quantity();
+        for (int i = 0; i < tick.venue_quantity_size() && i + 1 < (int) exchange_t::total; ++i)
+            level.qty[i + 1] = tick.venue_quantity(i);
+        level.notional = tick.price() * tick.quantity();
+    }
+
     // clear all levels on one exchange
     void clear_book(uint32_t exchange) {
         if (exchange < (uint32_t) exchange_t::total) {
@@ -78,7 +93,7 @@ struct sided_book {
                 it->second.qty[0] -= it->second.qty[exchange];
                 it->second.notional = it->second.price * it->second.qty[0];
                 if (is_equal(it->second.qty[0], 0)) {
-                    book_.erase(it);
+                    it = book_.erase(it);
                 } else {
                     it->second.qty[exchange] = 0;
                     ++it;
@@ -106,6 +121,19 @@ struct sided_book {
             return {};
         }
     }    
+
+    // append the levels quoted by one exchange
+    void snapshot(uint32_t exchange, side_t side, batched_tick_update& ticks) const {
+        for (const auto& [key, level] : book_) {
+            if (is_greater(level.qty[exchange], 0)) {
+                auto& tick = *ticks.add_updates();
+                tick.set_side((uint32_t) side);
+                tick.set_price(level.price);
+                tick.set_quantity(level.qty[exchange]);
+                tick.set_tick_id(ticks.tick_id());
+            }
+        }
+    }
 };
 
 // An order for 1 symbol
@@ -122,17 +150,53 @@ class basic_book {
             bids_.clear_book(exchange);
             asks_.clear_book(exchange);
         }
-        for (const auto& tick: ticks.updates()) {
-            if (tick.side() == (int) side_t::bid) {
-                bids_.update_tick(exchange, tick);
+        if (exchange == (uint32_t) exchange_t::undefined) {
+            for (const auto& tick: ticks.updates()) {
+                // a batch merged across exchanges: each update carries its exchange
+                if (tick.exchange() != (uint32_t) exchange_t::undefined) {
+                    update_tick(tick.exchange(), tick);
+                    continue;
+                }
+                if (tick.side() == (int) side_t::bid)
+                    bids_.update_consolidated(tick);
+                else if (tick.side() == (int) side_t::ask)
+                    asks_.update_consolidated(tick);
             }
-            else if (tick.side() == (int) side_t::ask) {
-                asks_.update_tick(exchange, tick);
-            }        
+            return;
         }
+        for (const auto& tick: ticks.updates())
+            update_tick(exchange, tick);
     }
 
+    // the best n levels of one side, best first: f(fixed price, level)
+    template <typename F>
+    void for_each_top(side_t side, size_t n, F&& f) const {
+        if (side == side_t::bid) {
+            for (auto it = bids_.book_.rbegin(); it != bids_.book_.rend() && n > 0; ++it, --n)
+                f(it->first, it->second);
+        } else {
+            for (auto it = asks_.book_.begin(); it != asks_.book_.end() && n > 0; ++it, --n)
+                f(it->first, it->second);
+        }
+    }
 
+    // the book of one exchange, as a batch flagged snapshot
+    void snapshot(uint32_t exchange, batched_tick_update& ticks) const {
+        ticks.set_exchange(exchange);
+        ticks.set_flag((uint64_t) updata_flag_t::snapshot);
+        if (exchange < (uint32_t) exchange_t::total) {
+            bids_.snapshot(exchange, side_t::bid, ticks);
+            asks_.snapshot(exchange, side_t::ask, ticks);
+        }
+    }
+
+    private:
+    void update_tick(uint32_t exchange, const tick_update& tick) {
+        if (tick.side() == (int) side_t::bid)
+            bids_.update_tick(exchange, tick);
+        else if (tick.side() == (int) side_t::ask)
+            asks_.update_tick(exchange, tick);
+    }
 };
 
 class extended_book : public basic_book {
@@ -159,14 +223,13 @@ class extended_book : public basic_book {
     std::vector<double>  volume_band(Iterator begin, Iterator end, const std::vector<double>& bands) const {
         std::vector<double> prices(bands.size());
         double accum = 0;
-        int index = 0;
-        for (Iterator it = begin; it!= end; ++it) {
-            auto band = bands[index];
+        size_t index = 0;
+        // stops once every band is filled: the bands come from the clients
+        for (Iterator it = begin; it != end && index < bands.size(); ++it) {
             accum += it->second.notional;
-            while ((index < bands.size()) && (accum >= band)) {
+            while (index < bands.size() && accum >= bands[index]) {
                 prices[index] = it->second.price;
                 ++index;
-                band = bands[index];
             }
         }
         return prices;
@@ -18,6 +18,9 @@ enum class updata_flag_t: uint64_t {
     underfined=0, snapshot
 };
 
+// prices are keyed in fixed point, by the client books and the server conflation
+constexpr int fixed_price_scale = 1'000'000;
+
 const double EPSILON = std::numeric_limits<double>::epsilon() * 100;
 
 bool is_equal(double a, double b) {
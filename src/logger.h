@@ -7,7 +7,16 @@
 #include "absl/log/log_sink.h"
 #include "absl/log/log_sink_registry.h"
 #include "absl/log/globals.h"
+#include "absl/time/clock.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 class file_log_sink : public absl::LogSink {
  public:
@@ -43,4 +52,263 @@ class file_log_sink : public absl::LogSink {
 };
 
 
-#endif
\ No newline at end of file
+
+// Counters shared by the async sink and the rate limited call sites.
+struct log_stats {
+    static inline std::atomic<uint64_t> dropped{0};        // ring full
+    static inline std::atomic<uint64_t> rate_limited{0};   // suppressed at the call site
+};
+
+// At most per_second lines per call site, checked before the message is formatted.
+class site_rate_limiter {
+ public:
+    explicit site_rate_limiter(uint32_t per_second) : per_second_(per_second) {}
+
+    bool allow() {
+        int64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        if (window_.load(std::memory_order_relaxed) != now) {
+            window_.store(now, std::memory_order_relaxed);
+            count_.store(0, std::memory_order_relaxed);
+        }
+        if (count_.fetch_add(1, std::memory_order_relaxed) < per_second_)
+            return true;
+        log_stats::rate_limited.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+ private:
+    const uint32_t per_second_;
+    std::atomic<int64_t> window_{0};
+    std::atomic<uint32_t> count_{0};
+};
+
+// default budget for per message log lines on the hot path
+constexpr uint32_t hot_path_log_rate = 100;
+
+#define LOG_RATE_LIMITED(severity, per_second) \
+    LOG_IF(severity, ([] { static site_rate_limiter limiter(per_second); return limiter.allow(); })())
+
+
+// Bounded lock-free multi producer / single consumer ring of log lines.
+// Each cell carries a sequence number (Vyukov's bounded queue), so producers
+// only contend on the tail index and never block; a full ring drops the line.
+class log_ring {
+ public:
+    static constexpr size_t max_text = 1024;
+    static constexpr size_t max_file = 64;
+
+    struct record {
+        absl::Time timestamp;
+        absl::LogSeverity severity;
+        int line;
+        uint16_t file_len;
+        uint16_t text_len;
+        char file[max_file];
+        char text[max_text];
+    };
+
+    explicit log_ring(size_t capacity) : cells_(round_up(capacity)), mask_(cells_.size() - 1) {
+        for (size_t i = 0; i < cells_.size(); ++i)
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    bool push(const absl::LogEntry& entry) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        cell* c;
+        while (true) {
+            c = &cells_[pos & mask_];
+            size_t seq = c->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t) seq - (intptr_t) pos;
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;   // full
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+
+        record& r = c->data;
+        r.timestamp = entry.timestamp();
+        r.severity = entry.log_severity();
+        r.line = entry.source_line();
+        r.file_len = copy_truncated(r.file, max_file, entry.source_filename());
+        r.text_len = copy_truncated(r.text, max_text, entry.text_message());
+        c->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // single consumer
+    const record* front() {
+        cell& c = cells_[head_ & mask_];
+        if (c.sequence.load(std::memory_order_acquire) != head_ + 1)
+            return nullptr;
+        return &c.data;
+    }
+
+    void pop() {
+        cells_[head_ & mask_].sequence.store(head_ + mask_ + 1, std::memory_order_release);
+        ++head_;
+    }
+
+ private:
+    struct cell {
+        std::atomic<size_t> sequence;
+        record data;
+    };
+
+    static size_t round_up(size_t n) {
+        size_t size = 1;
+        while (size < n) size <<= 1;
+        return size;
+    }
+
+    static uint16_t copy_truncated(char* dst, size_t cap, absl::string_view src) {
+        size_t n = std::min(src.size(), cap);
+        std::memcpy(dst, src.data(), n);
+        return (uint16_t) n;
+    }
+
+    std::vector<cell> cells_;
+    const size_t mask_;
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) size_t head_ = 0;
+};
+
+
+// Same output as file_log_sink, but Send() only copies the line into a
+// lock-free ring. A background thread formats and writes the lines in
+// batches, with one flush per batch instead of one per line. ERROR and FATAL
+// lines are written by Send() itself, after what is queued: a FATAL one is
+// in the file before the process aborts.
+class async_file_log_sink : public absl::LogSink {
+ public:
+    explicit async_file_log_sink(const std::string& filename, size_t capacity = 8192)
+        : ring_(capacity)
+    {
+        absl::SetStderrThreshold(absl::LogSeverity::kFatal); // to disable most console log
+        log_file_.open(filename + ".log", std::ios::out | std::ios::app);
+        writer_ = std::thread([this] { run(); });
+        absl::AddLogSink(this);
+    }
+
+    ~async_file_log_sink() override {
+        absl::RemoveLogSink(this);
+        running_.store(false, std::memory_order_release);
+        if (writer_.joinable()) writer_.join();
+        if (log_file_.is_open()) log_file_.close();
+    }
+
+    void Send(const absl::LogEntry& entry) override {
+        if (entry.log_severity() < absl::LogSeverity::kError) {
+            if (!ring_.push(entry))
+                log_stats::dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::lock_guard<std::mutex> lock(file_mutex_);
+        drain(SIZE_MAX);
+        batch_.clear();
+        format(entry.timestamp(), entry.log_severity(), entry.source_filename(), entry.source_line(),
+            entry.text_message(), false, batch_);
+        write_batch();
+    }
+
+    // writes what is queued, for absl::FlushLogSinks() and before an abort
+    void Flush() override {
+        std::lock_guard<std::mutex> lock(file_mutex_);
+        drain(SIZE_MAX);
+    }
+
+    void set_log_level(absl::LogSeverity level) {
+        absl::SetStderrThreshold(level);
+    }
+
+ private:
+    static constexpr size_t max_batch = 512;
+
+    void run() {
+        while (true) {
+            bool running = running_.load(std::memory_order_acquire);
+            size_t n;
+            {
+                std::lock_guard<std::mutex> lock(file_mutex_);
+                n = drain(max_batch);
+            }
+            if (n == 0) {
+                if (!running) break;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+
+    // Writes up to max lines of the ring, and the lines lost since the last
+    // time, under file_mutex_. Returns the number of lines taken.
+    size_t drain(size_t max) {
+        size_t n = 0;
+        batch_.clear();
+        while (n < max) {
+            const log_ring::record* r = ring_.front();
+            if (!r) break;
+            format(r->timestamp, r->severity, absl::string_view(r->file, r->file_len), r->line,
+                absl::string_view(r->text, r->text_len), r->text_len == log_ring::max_text, batch_);
+            ring_.pop();
+            ++n;
+        }
+
+        uint64_t dropped = log_stats::dropped.load(std::memory_order_relaxed);
+        uint64_t limited = log_stats::rate_limited.load(std::memory_order_relaxed);
+        if (dropped != reported_dropped_ || limited != reported_limited_) {
+            batch_ += absl::FormatTime(absl::RFC3339_full, absl::Now(), absl::LocalTimeZone());
+            batch_ += " [WARNING] logger: dropped " + std::to_string(dropped - reported_dropped_)
+                + " lines, rate limited " + std::to_string(limited - reported_limited_) + " lines\n";
+            reported_dropped_ = dropped;
+            reported_limited_ = limited;
+        }
+        write_batch();
+        return n;
+    }
+
+    void write_batch() {
+        if (!batch_.empty() && log_file_.is_open()) {
+            log_file_.write(batch_.data(), batch_.size());
+            log_file_.flush();
+        }
+    }
+
+    static void format(absl::Time timestamp, absl::LogSeverity severity, absl::string_view file, int line,
+        absl::string_view text, bool truncated, std::string& out) {
+        out += absl::FormatTime(absl::RFC3339_full, timestamp, absl::LocalTimeZone());
+        out += " [";
+        out += absl::LogSeverityName(severity);
+        out += "] ";
+        out.append(file.data(), file.size());
+        out += ":";
+        out += std::to_string(line);
+        out += " ";
+        out.append(text.data(), text.size());
+        if (truncated)
+            out += "...";
+        out += "\n";
+    }
+
+    log_ring ring_;
+    std::mutex file_mutex_;     // the file, the batch and the consumer side of the ring
+    std::ofstream log_file_;
+    std::string batch_;
+    uint64_t reported_dropped_ = 0;
+    uint64_t reported_limited_ = 0;
+    std::atomic<bool> running_{true};
+    std::thread writer_;
+};
+
+
+inline std::unique_ptr<absl::LogSink> make_log_sink(const std::string& filename, bool async) {
+    if (async)
+        return std::make_unique<async_file_log_sink>(filename);
+    return std::make_unique<file_log_sink>(filename);
+}
+
+
+#endif
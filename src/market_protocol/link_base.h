@@ -0,0 +1,125 @@
+#ifndef _LINK_BASE_H_
+#define _LINK_BASE_H_
+
+
+#include <Poco/JSON/Parser.h>
+#include <Poco/JSON/Object.h>
+
+#include "wws_link.h"
+#include "link_config.h"
+#include "symbol_router.h"
+#include "../common.h"
+#include "../logger.h"
+#include "../binlog.h"
+
+
+namespace market_protocol {
+
+// Common interface of the exchange links, used for set up and management.
+class link_interface {
+public:
+    virtual ~link_interface() = default;
+    virtual void connect() = 0;
+    virtual bool poll() = 0;
+    virtual void set_callback(tick_callback cb) = 0;
+    virtual exchange_t get_exchange() const = 0;
+    virtual const link_config& config() const = 0;
+};
+
+// Shared plumbing of the links: websocket, routing table and message parsing.
+// The venue specific parts are dispatched statically to Derived:
+//   std::string make_url() const;
+//   void on_connected();
+//   void handle_message(Poco::JSON::Object::Ptr obj);
+//   void on_idle();                        (optional)
+template <typename Derived>
+class link_base : public link_interface {
+protected:
+    link_config config_;
+    tick_callback callback_;
+    wws_link websocket_;
+    std::string url_;
+    symbol_router router_;
+    batched_tick_update ticks_;
+
+    Derived& derived() { return static_cast<Derived&>(*this); }
+
+    const std::string& end_point() const {
+        return config_.end_point.empty() ? Derived::default_end_point : config_.end_point;
+    }
+
+    void send_json(Poco::JSON::Object::Ptr json) {
+        std::stringstream ss;
+        Poco::JSON::Stringifier::stringify(json, ss);
+        std::string jsonStr = ss.str();
+
+        websocket_.send_message(jsonStr.c_str(), jsonStr.length());
+    }
+
+    // The batch handle_depth fills, reused from one message to the next:
+    // Clear() keeps the tick_update objects, so once the batches have been as
+    // large, add_updates() does not allocate. callback_ must not keep it.
+    batched_tick_update& next_batch() {
+        ticks_.Clear();
+        return ticks_;
+    }
+
+    void on_connected() {}
+    void on_idle() {}
+
+public:
+    link_base(symbol_registry& registry, link_config config) :
+        config_(std::move(config)),
+        router_(registry, config_.symbols)
+    {
+    }
+
+    void connect() override {
+        url_ = derived().make_url();
+        websocket_.connect(url_);
+        derived().on_connected();
+    }
+
+    void set_callback(tick_callback cb) override {
+        callback_ = std::move(cb);
+    }
+
+    exchange_t get_exchange() const override {
+        return Derived::exchange;
+    }
+
+    const link_config& config() const override {
+        return config_;
+    }
+
+    bool poll() override {
+        char buffer[200000];
+        int n = websocket_.poll(buffer, sizeof(buffer));
+        if (n > 0) {
+            try {
+                std::string msg(buffer, n);
+                if (binlog::enabled())
+                    BINLOG("Received from exchange {}: {}", (uint32_t) Derived::exchange, binlog::blob{buffer, (uint32_t) n});
+                else
+                    LOG_RATE_LIMITED(INFO, hot_path_log_rate) << "Received: " << msg;
+
+                Poco::JSON::Parser parser;
+                Poco::Dynamic::Var result = parser.parse(msg);
+                Poco::JSON::Object::Ptr obj = result.extract<Poco::JSON::Object::Ptr>();
+
+                derived().handle_message(obj);
+                return true;
+            } catch (const Poco::Exception& ex) {
+                LOG(ERROR) << "POCO Exception: " << ex.displayText();
+            } catch (const std::exception& ex) {
+                LOG(ERROR) << "Exception: " << ex.what();
+            }
+        } else
+            derived().on_idle();
+        return false;
+    }
+};
+
+}   // namespace market_protocol
+
+#endif  // _LINK_BASE_H_
@@ -7,7 +7,7 @@
 #include <Poco/JSON/Object.h>
 
 
-#include "wws_link.h"
+#include "link_base.h"
 #include "../common.h"
 #include "../logger.h"
 
@@ -19,15 +19,11 @@ using agg_proto::batched_tick_update;
 
 namespace market_protocol {
 
-class binance_link {
+class binance_link final : public link_base<binance_link> {
 private:    
+    friend class link_base<binance_link>;
     static constexpr exchange_t exchange = exchange_t::binance;
-    const std::string end_point = "wss://data-stream.binance.vision:9443";
-    std::function<void(const batched_tick_update&)> callback_;
-    wws_link websocket_;
-    std::string url_;
-    std::unique_ptr<Poco::Net::WebSocket> ws_;
-    std::string symbol_;
+    static inline const std::string default_end_point = "wss://data-stream.binance.vision:9443";
 
     
 /*
@@ -51,55 +47,54 @@ Diff. Depth Stream
     ]
   ]
 }
+
+Combined stream, one connection for many symbols (up to 1024 streams)
+wss://data-stream.binance.vision:9443/stream?streams=btcusdt@depth/ethusdt@depth
+{
+  "stream": "btcusdt@depth",
+  "data": { ... Diff. Depth Stream payload ... }
+}
 */
 
 public:
-    binance_link(std::string symbol, std::string market_symbol) : 
-        symbol_(symbol)
-    {
-        url_ = end_point + "/ws/" + market_symbol + "@depth";
-    }
+    static constexpr const char* venue = "binance";
 
-    void connect() {
-        websocket_.connect(url_);
+    binance_link(symbol_registry& registry, link_config config) : 
+        link_base(registry, std::move(config))
+    {
     }
 
-    void set_callback(std::function<void(const batched_tick_update&)> cb) {
-        callback_ = std::move(cb);
+protected:
+    // depth is not used: the diff stream always carries every changed level
+    std::string make_url() const {
+        std::string speed = config_.update_frequency == 100 ? "@100ms" : "";
+        std::string url = end_point() + "/stream?streams=";
+        for (const auto& m : router_.mappings()) {
+            if (url.back() != '=')
+                url += "/";
+            url += m.market_symbol + "@depth" + speed;
+        }
+        return url;
     }
 
-    bool poll() {
-        char buffer[200000];
-        int n = websocket_.poll(buffer, sizeof(buffer));
-        if (n > 0) {
-            try {
-                std::string msg(buffer, n);
-                LOG(INFO) << "Received: " << msg;
-
-                Poco::JSON::Parser parser;
-                Poco::Dynamic::Var result = parser.parse(msg);
-                Poco::JSON::Object::Ptr obj = result.extract<Poco::JSON::Object::Ptr>();
-
-                // std::string event = obj->getValue<std::string>("e");
-                handle_depth(obj);
-
-                return true;
-            } catch (const Poco::Exception& ex) {
-                LOG(ERROR) << "POCO Exception: " << ex.displayText();
-            } catch (const std::exception& ex) {
-                LOG(ERROR) << "Exception: " << ex.what();
-            }
+    void handle_message(Poco::JSON::Object::Ptr obj) {
+        // stream name is <market_symbol>@depth
+        std::string stream = obj->getValue<std::string>("stream");
+        symbol_id_t symbol_id = router_.route(stream.substr(0, stream.find('@')));
+        if (symbol_id == invalid_symbol_id) {
+            LOG(WARNING) << "Unknown stream: " << stream;
+            return;
         }
-        return false;
+
+        // std::string event = obj->getValue<std::string>("e");
+        handle_depth(symbol_id, obj->getObject("data"));
     }
 
-protected:        
-    void handle_depth(Poco::JSON::Object::Ptr obj) {
-        // tick_update tick;
-        batched_tick_update ticks;
+    void handle_depth(symbol_id_t symbol_id, Poco::JSON::Object::Ptr obj) {
+        batched_tick_update& ticks = next_batch();
         ticks.set_exchange((uint32_t) exchange);
         // ticks.set_symbol(obj->getValue<std::string>("s"));
-        ticks.set_symbol(symbol_);
+        ticks.set_symbol_id(symbol_id);
         ticks.set_tick_id(obj->getValue<int64_t>("E")); 
         auto update_ticks = [&] (Poco::JSON::Array::Ptr tick_array, side_t side) {
             for (size_t i = 0; i < tick_array->size(); ++i) {
@@ -118,7 +113,7 @@ protected:
         if (callback_) {
             update_ticks(bids, side_t::bid);
             update_ticks(asks, side_t::ask);
-            callback_(ticks);
+            callback_(symbol_id, ticks);
         }
     }
 
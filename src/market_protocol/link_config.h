@@ -0,0 +1,95 @@
+#ifndef _LINK_CONFIG_H_
+#define _LINK_CONFIG_H_
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <Poco/JSON/Parser.h>
+#include <Poco/JSON/Object.h>
+
+#include "symbol_router.h"
+
+
+namespace market_protocol {
+
+/*
+One entry per exchange connection. A venue may appear more than once, to
+spread its symbols over several connections, and each aggregator process
+can be given its own file to shard symbols across processes.
+{
+  "links": [
+    {
+      "venue": "binance",
+      "end_point": "wss://data-stream.binance.vision:9443",   // optional, venue default otherwise
+      "depth": 50,                                            // levels, where the venue supports it
+      "update_frequency": 100,                                // ms, where the venue supports it
+      "symbols": [
+        { "symbol": "BTCUSDT", "market_symbol": "btcusdt",
+          "tick_size": 0.01, "lot_size": 0.00001 }               // optional, for ListSymbols
+      ]
+    }
+  ]
+}
+*/
+struct link_config {
+    std::string venue;
+    std::string end_point;
+    std::vector<symbol_mapping> symbols;
+    int depth = 0;              // 0: venue default
+    int update_frequency = 0;   // 0: venue default
+};
+
+
+inline std::vector<link_config> default_link_config() {
+    return {
+        {"binance",   "", {{"BTCUSDT", "btcusdt"}}},
+        {"kraken",    "", {{"BTCUSDT", "BTC/USDT"}}},
+        {"cryptocom", "", {{"BTCUSDT", "BTC_USDT"}}, 50, 10},
+    };
+}
+
+inline std::vector<link_config> load_link_config(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open())
+        throw std::runtime_error("cannot open config " + filename);
+    std::stringstream ss;
+    ss << file.rdbuf();
+
+    Poco::JSON::Parser parser;
+    Poco::JSON::Object::Ptr root = parser.parse(ss.str()).extract<Poco::JSON::Object::Ptr>();
+    Poco::JSON::Array::Ptr links = root->getArray("links");
+
+    std::vector<link_config> configs;
+    for (size_t i = 0; i < links->size(); ++i) {
+        Poco::JSON::Object::Ptr link = links->getObject(i);
+        link_config config;
+        config.venue = link->getValue<std::string>("venue");
+        if (link->has("end_point"))
+            config.end_point = link->getValue<std::string>("end_point");
+        if (link->has("depth"))
+            config.depth = link->getValue<int>("depth");
+        if (link->has("update_frequency"))
+            config.update_frequency = link->getValue<int>("update_frequency");
+
+        Poco::JSON::Array::Ptr symbols = link->getArray("symbols");
+        for (size_t j = 0; j < symbols->size(); ++j) {
+            Poco::JSON::Object::Ptr symbol = symbols->getObject(j);
+            config.symbols.push_back({
+                symbol->getValue<std::string>("symbol"),
+                symbol->getValue<std::string>("market_symbol")
+            });
+            if (symbol->has("tick_size"))
+                config.symbols.back().sizes.tick_size = symbol->getValue<double>("tick_size");
+            if (symbol->has("lot_size"))
+                config.symbols.back().sizes.lot_size = symbol->getValue<double>("lot_size");
+        }
+        configs.push_back(std::move(config));
+    }
+    return configs;
+}
+
+}   // namespace market_protocol
+
+#endif  // _LINK_CONFIG_H_
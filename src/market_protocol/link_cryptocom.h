@@ -7,7 +7,7 @@
 #include <Poco/JSON/Object.h>
 
 
-#include "wws_link.h"
+#include "link_base.h"
 #include "../common.h"
 #include "../logger.h"
 
@@ -20,16 +20,11 @@ using agg_proto::batched_tick_update;
 
 namespace market_protocol {
 
-class cryptocom_link {
+class cryptocom_link final : public link_base<cryptocom_link> {
 private:
+    friend class link_base<cryptocom_link>;
     static constexpr exchange_t exchange = exchange_t::cryptocom;
-    const std::string end_point = "wss://stream.crypto.com:443";
-    std::function<void(const batched_tick_update&)> callback_;
-    wws_link websocket_;
-    std::string url_;
-    std::unique_ptr<Poco::Net::WebSocket> ws_;
-    std::string symbol_;
-    std::string market_symbol_;
+    static inline const std::string default_end_point = "wss://stream.crypto.com:443";
 
     
 /*
@@ -37,97 +32,76 @@ https://exchange-docs.crypto.com/exchange/v1/rest-ws/index.html#book-instrument_
 {
   "method": "subscribe",
   "params": {
-    "channels": ["book.BTC_USDT"]
+    "channels": ["book.BTC_USDT.50", "book.ETH_USDT.50"],
+    "book_subscription_type": "SNAPSHOT_AND_UPDATE",
+    "book_update_frequency": 10
   },
   "id": 1
 }
 
+Each update carries "instrument_name", which is used to route it.
+
     
 */
 
 public:
-    cryptocom_link(std::string symbol, std::string market_symbol) : 
-        symbol_(symbol),
-        market_symbol_(market_symbol)
+    static constexpr const char* venue = "cryptocom";
+
+    cryptocom_link(symbol_registry& registry, link_config config) : 
+        link_base(registry, std::move(config))
     {
-        url_ = end_point + "/exchange/v1/market";
     }
 
-    void connect() {
-        websocket_.connect(url_);
+protected:
+    std::string make_url() const {
+        return end_point() + "/exchange/v1/market";
+    }
 
+    void on_connected() {
+        int depth = config_.depth > 0 ? config_.depth : 50;
+        int update_frequency = config_.update_frequency > 0 ? config_.update_frequency : 10;
 
         Poco::JSON::Object::Ptr json = new Poco::JSON::Object;
         json->set("id", 1);
         json->set("method", "subscribe");
         Poco::JSON::Object::Ptr params = new Poco::JSON::Object;
         Poco::JSON::Array::Ptr channels = new Poco::JSON::Array;
-        channels->add("book." + market_symbol_ + ".50");
+        for (const auto& m : router_.mappings())
+            channels->add("book." + m.market_symbol + "." + std::to_string(depth));
         params->set("channels", channels);
         params->set("book_subscription_type", "SNAPSHOT_AND_UPDATE");
-        params->set("book_update_frequency", 10);
+        params->set("book_update_frequency", update_frequency);
         json->set("params", params);
 
-        std::stringstream ss;
-        Poco::JSON::Stringifier::stringify(json, ss);
-        std::string jsonStr = ss.str();
-     
-        websocket_.send_message(jsonStr.c_str(), jsonStr.length());
+        send_json(json);
     }
 
-    void set_callback(std::function<void(const batched_tick_update&)> cb) {
-        callback_ = std::move(cb);
-    }
+    void handle_message(Poco::JSON::Object::Ptr obj) {
+        std::string method = obj->getValue<std::string>("method");
+        if (method == "subscribe") {
 
-    bool poll() {
-        char buffer[200000];
-        int n = websocket_.poll(buffer, sizeof(buffer));
-        if (n > 0) {
-            try {
-                std::string msg(buffer, n);
-                LOG(INFO) << "Received: " << msg;
-
-                Poco::JSON::Parser parser;
-                Poco::Dynamic::Var result = parser.parse(msg);
-                Poco::JSON::Object::Ptr obj = result.extract<Poco::JSON::Object::Ptr>();
-
-                std::string method = obj->getValue<std::string>("method");
-                if (method == "subscribe") {
-
-                    if (obj->has("result")) {
-                        Poco::JSON::Object::Ptr result = obj->getObject("result");
-                        if (result->has("data"))
-                            handle_depth(result);
-                    }
-                }
-                else if (method == "public/heartbeat") {
-
-                    
-                    Poco::JSON::Object::Ptr json = new Poco::JSON::Object;
-                    json->set("method", "public/respond-heartbeat");
-                    json->set("id", obj->getValue<int64_t>("id"));
-
-                    std::stringstream ss;
-                    Poco::JSON::Stringifier::stringify(json, ss);
-                    std::string jsonStr = ss.str();
-                
-                    websocket_.send_message(jsonStr.c_str(), jsonStr.length());
-                    
-                    
-                }
-                return true;
-            } catch (const Poco::Exception& ex) {
-                LOG(ERROR) << "POCO Exception: " << ex.displayText();
-            } catch (const std::exception& ex) {
-                LOG(ERROR) << "Exception: " << ex.what();
+            if (obj->has("result")) {
+                Poco::JSON::Object::Ptr result = obj->getObject("result");
+                if (result->has("data"))
+                    handle_depth(result);
             }
         }
-        return false;
+        else if (method == "public/heartbeat") {
+
+            Poco::JSON::Object::Ptr json = new Poco::JSON::Object;
+            json->set("method", "public/respond-heartbeat");
+            json->set("id", obj->getValue<int64_t>("id"));
+
+            send_json(json);
+        }
     }
 
-protected:        
     void handle_depth(Poco::JSON::Object::Ptr obj) {
-        batched_tick_update ticks;
+        symbol_id_t symbol_id = router_.route(obj->getValue<std::string>("instrument_name"));
+        if (symbol_id == invalid_symbol_id)
+            return;
+
+        batched_tick_update& ticks = next_batch();
 
         std::string channel = obj->getValue<std::string>("channel");
         bool is_update = channel == "book.update";
@@ -142,7 +116,7 @@ protected:
             Poco::JSON::Object::Ptr entry = dataArray->getObject(0);
             ticks.set_exchange((uint32_t) exchange);
             // ticks.set_symbol(entry->getValue<std::string>("symbol"));
-            ticks.set_symbol(symbol_);
+            ticks.set_symbol_id(symbol_id);
             ticks.set_tick_id(entry->getValue<int64_t>("t")); 
             auto update_ticks = [&] (Poco::JSON::Array::Ptr tick_array, side_t side) {
                 for (size_t i = 0; i < tick_array->size(); ++i) {
@@ -169,7 +143,7 @@ protected:
             if (callback_) {
                 update_ticks(bids, side_t::bid);
                 update_ticks(asks, side_t::ask);
-                callback_(ticks);
+                callback_(symbol_id, ticks);
             }
 
         }
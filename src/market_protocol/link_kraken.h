@@ -7,7 +7,7 @@
 #include <Poco/JSON/Object.h>
 
 
-#include "wws_link.h"
+#include "link_base.h"
 #include "../common.h"
 #include "../logger.h"
 
@@ -22,16 +22,11 @@ using agg_proto::batched_tick_update;
 
 namespace market_protocol {
 
-class kraken_link {
+class kraken_link final : public link_base<kraken_link> {
 private:    
+    friend class link_base<kraken_link>;
     static constexpr exchange_t exchange = exchange_t::kraken;
-    const std::string end_point = "wss://ws.kraken.com:443";
-    std::function<void(const batched_tick_update&)> callback_;
-    wws_link websocket_;
-    std::string url_;
-    std::unique_ptr<Poco::Net::WebSocket> ws_;
-    std::string symbol_;
-    std::string market_symbol_;
+    static inline const std::string default_end_point = "wss://ws.kraken.com:443";
     std::chrono::steady_clock::time_point last_heartbeat_time_;
     static const int HEARTBEAT_INTERVAL_SECONDS = 10;
 
@@ -43,6 +38,7 @@ https://docs.kraken.com/api/docs/websocket-v2/book
     "method": "subscribe",
     "params": {
         "channel": "book",
+        "depth": 10,
         "symbol": [
             "ALGO/USD",
             "MATIC/USD"
@@ -53,38 +49,14 @@ https://docs.kraken.com/api/docs/websocket-v2/book
 */
 
 public:
-    kraken_link(std::string symbol, std::string market_symbol) : 
-        symbol_(symbol),
-        market_symbol_(market_symbol)
+    static constexpr const char* venue = "kraken";
+
+    kraken_link(symbol_registry& registry, link_config config) : 
+        link_base(registry, std::move(config))
     {
-        url_ = end_point + "/v2";
         last_heartbeat_time_ = std::chrono::steady_clock::now();
     }
 
-    void connect() {
-        websocket_.connect(url_);
-
-
-        Poco::JSON::Object::Ptr json = new Poco::JSON::Object;
-        json->set("method", "subscribe");
-        Poco::JSON::Object::Ptr params = new Poco::JSON::Object;
-        params->set("channel", "book");
-        Poco::JSON::Array::Ptr symbols = new Poco::JSON::Array;
-        symbols->add(market_symbol_);
-        params->set("symbol", symbols);
-        json->set("params", params);
-
-        std::stringstream ss;
-        Poco::JSON::Stringifier::stringify(json, ss);
-        std::string jsonStr = ss.str();
-     
-        websocket_.send_message(jsonStr.c_str(), jsonStr.length());
-    }
-
-    void set_callback(std::function<void(const batched_tick_update&)> cb) {
-        callback_ = std::move(cb);
-    }
-
     void send_ping() {
         static const std::string ping_msg = R"({"method": "ping", "req_id": 101})";
 
@@ -103,48 +75,54 @@ public:
         return false;
     }
 
-    bool poll() {
-        char buffer[200000];
-        int n = websocket_.poll(buffer, sizeof(buffer));
-        if (n > 0) {
-            try {
-                std::string msg(buffer, n);
-                LOG(INFO) << "Received: " << msg;
-
-                Poco::JSON::Parser parser;
-                Poco::Dynamic::Var result = parser.parse(msg);
-                Poco::JSON::Object::Ptr obj = result.extract<Poco::JSON::Object::Ptr>();
-
-                if (obj->has("channel")) {
-                    std::string channel = obj->getValue<std::string>("channel");
-                    if (channel == "book") {
-                        if (obj->has("type") && (obj->getValue<std::string>("type") == "update") )
-                            handle_depth(obj);
-                    }
-                }
+protected:
+    // update frequency is not configurable on kraken
+    std::string make_url() const {
+        return end_point() + "/v2";
+    }
 
-                return true;
-            } catch (const Poco::Exception& ex) {
-                LOG(ERROR) << "POCO Exception: " << ex.displayText();
-            } catch (const std::exception& ex) {
-                LOG(ERROR) << "Exception: " << ex.what();
-            }
-        } else 
-            check_heartbeat();
-        return false;
+    void on_connected() {
+        Poco::JSON::Object::Ptr json = new Poco::JSON::Object;
+        json->set("method", "subscribe");
+        Poco::JSON::Object::Ptr params = new Poco::JSON::Object;
+        params->set("channel", "book");
+        if (config_.depth > 0)
+            params->set("depth", config_.depth);
+        Poco::JSON::Array::Ptr symbols = new Poco::JSON::Array;
+        for (const auto& m : router_.mappings())
+            symbols->add(m.market_symbol);
+        params->set("symbol", symbols);
+        json->set("params", params);
+
+        send_json(json);
     }
 
-protected:        
-    void handle_depth(Poco::JSON::Object::Ptr obj) {
-        batched_tick_update ticks;
+    void on_idle() {
+        check_heartbeat();
+    }
 
+    void handle_message(Poco::JSON::Object::Ptr obj) {
+        if (obj->has("channel")) {
+            std::string channel = obj->getValue<std::string>("channel");
+            if (channel == "book") {
+                if (obj->has("type") && (obj->getValue<std::string>("type") == "update") )
+                    handle_depth(obj);
+            }
+        }
+    }
 
+    void handle_depth(Poco::JSON::Object::Ptr obj) {
         Poco::JSON::Array::Ptr dataArray = obj->getArray("data");
-        if (!dataArray->empty()) {
-            Poco::JSON::Object::Ptr entry = dataArray->getObject(0);
+        // one entry per symbol in the update
+        for (size_t n = 0; n < dataArray->size(); ++n) {
+            Poco::JSON::Object::Ptr entry = dataArray->getObject(n);
+            symbol_id_t symbol_id = router_.route(entry->getValue<std::string>("symbol"));
+            if (symbol_id == invalid_symbol_id)
+                continue;
+
+            batched_tick_update& ticks = next_batch();
             ticks.set_exchange((uint32_t) exchange);
-            // ticks.set_symbol(entry->getValue<std::string>("symbol"));
-            ticks.set_symbol(symbol_);
+            ticks.set_symbol_id(symbol_id);
             //ticks.set_tick_id(obj->getValue<int64_t>("timestamp")); 
             auto update_ticks = [&] (Poco::JSON::Array::Ptr tick_array, side_t side) {
                 for (size_t i = 0; i < tick_array->size(); ++i) {
@@ -165,7 +143,7 @@ protected:
             if (callback_) {
                 update_ticks(bids, side_t::bid);
                 update_ticks(asks, side_t::ask);
-                callback_(ticks);
+                callback_(symbol_id, ticks);
             }
 
         }
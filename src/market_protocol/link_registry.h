@@ -0,0 +1,78 @@
+#ifndef _LINK_REGISTRY_H_
+#define _LINK_REGISTRY_H_
+
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "link_base.h"
+#include "link_config.h"
+#include "link_binance.h"
+#include "link_kraken.h"
+#include "link_cryptocom.h"
+#include "../logger.h"
+
+
+namespace market_protocol {
+
+// Owns the exchange links created from config.
+// Links are kept in one vector per concrete type, so the polling loop calls
+// the final classes directly and never goes through the virtual interface.
+template <typename... Links>
+class basic_link_registry {
+private:
+    std::tuple<std::vector<std::unique_ptr<Links>>...> links_;
+    std::vector<link_interface*> all_;
+
+    template <typename Link>
+    bool try_create(symbol_registry& symbols, const link_config& config) {
+        if (config.venue != Link::venue)
+            return false;
+        auto link = std::make_unique<Link>(symbols, config);
+        all_.push_back(link.get());
+        std::get<std::vector<std::unique_ptr<Link>>>(links_).push_back(std::move(link));
+        return true;
+    }
+
+public:
+    void create(symbol_registry& symbols, const link_config& config) {
+        if (!(try_create<Links>(symbols, config) || ...))
+            throw std::runtime_error("unknown venue " + config.venue);
+        LOG(INFO) << "link created: " << config.venue << ", " << config.symbols.size() << " symbols";
+    }
+
+    void create(symbol_registry& symbols, const std::vector<link_config>& configs) {
+        for (const auto& config : configs)
+            create(symbols, config);
+    }
+
+    void set_callback(tick_callback cb) {
+        for (auto* link : all_)
+            link->set_callback(cb);
+    }
+
+    void connect() {
+        for (auto* link : all_)
+            link->connect();
+    }
+
+    void poll() {
+        std::apply([] (auto&... links) {
+            auto poll_all = [] (auto& v) {
+                for (auto& link : v)
+                    link->poll();
+            };
+            (poll_all(links), ...);
+        }, links_);
+    }
+
+    const std::vector<link_interface*>& links() const {
+        return all_;
+    }
+};
+
+using link_registry = basic_link_registry<binance_link, kraken_link, cryptocom_link>;
+
+}   // namespace market_protocol
+
+#endif  // _LINK_REGISTRY_H_
@@ -0,0 +1,64 @@
+#ifndef _SYMBOL_ROUTER_H_
+#define _SYMBOL_ROUTER_H_
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../symbol_registry.h"
+#include "../protos/aggregator.grpc.pb.h"
+
+using agg_proto::batched_tick_update;
+
+
+namespace market_protocol {
+
+// callback from a link to the publisher, with the internal symbol id already resolved
+using tick_callback = std::function<void(symbol_id_t, const batched_tick_update&)>;
+
+struct symbol_mapping {
+    std::string symbol;         // internal symbol, e.g. BTCUSDT
+    std::string market_symbol;  // venue symbol, e.g. btcusdt / BTC/USDT / BTC_USDT
+    symbol_sizes sizes;         // optional, listed by ListSymbols
+};
+
+// Routing table of one link: venue symbol -> internal symbol id.
+// Built once at start-up, looked up once per message.
+class symbol_router {
+private:
+    const symbol_registry& registry_;
+    std::vector<symbol_mapping> mappings_;
+    std::unordered_map<std::string, symbol_id_t> routes_;
+
+public:
+    symbol_router(symbol_registry& registry, std::vector<symbol_mapping> mappings) :
+        registry_(registry),
+        mappings_(std::move(mappings))
+    {
+        routes_.reserve(mappings_.size());
+        for (const auto& m : mappings_) {
+            symbol_id_t id = registry.intern(m.symbol);
+            routes_[m.market_symbol] = id;
+            if (m.sizes.tick_size > 0 || m.sizes.lot_size > 0)
+                registry.set_sizes(id, m.sizes);
+        }
+    }
+
+    symbol_id_t route(const std::string& market_symbol) const {
+        auto it = routes_.find(market_symbol);
+        return it != routes_.end() ? it->second : invalid_symbol_id;
+    }
+
+    const std::string& symbol(symbol_id_t id) const {
+        return registry_.name(id);
+    }
+
+    const std::vector<symbol_mapping>& mappings() const {
+        return mappings_;
+    }
+};
+
+}   // namespace market_protocol
+
+#endif  // _SYMBOL_ROUTER_H_
@@ -1,23 +1,46 @@
 #ifndef _AGG_SERVER_HPP_
 #define _AGG_SERVER_HPP_
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <memory>
+#include <random>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
-#include <queue>
 
+#include <grpcpp/alarm.h>
 #include <grpcpp/ext/proto_server_reflection_plugin.h>
 #include <grpcpp/grpcpp.h>
 #include <grpcpp/health_check_service_interface.h>
 
+#include "absl/strings/str_format.h"
+
 #include "../protos/aggregator.grpc.pb.h"
+#include "../symbol_registry.h"
+#include "client_queue.h"
+#include "analytics_views.h"
+#include "batch_window.h"
+#include "broadcast_ring.h"
+#include "consolidated_books.h"
+#include "depth_views.h"
+#include "replay_ring.h"
+#include "subscriber_index.h"
 #include "../logger.h"
+#include "../binlog.h"
+#include "../shm_bbo.h"
+#include "../shm_ring.h"
 
 using agg_proto::agg_service;
 using agg_proto::tick_request;
 using agg_proto::tick_update;
 using agg_proto::batched_tick_update;
+using agg_proto::tick_snapshot;
+using agg_proto::symbol_list_request;
+using agg_proto::symbol_list;
 
 using grpc::Server;
 using grpc::ServerBuilder;
@@ -26,6 +49,17 @@ using grpc::ServerReader;
 using grpc::Status;
 
 
+// The batched stream is served raw: each batch is serialized once into a
+// grpc::ByteBuffer and the same ref-counted slices are queued to every client.
+// So are the analytics streams, whose updates are shared by every stream with
+// the same parameters.
+using agg_async_service = agg_service::WithAsyncMethod_TickSnapshotRequest<
+    agg_service::WithAsyncMethod_TickStreamRequest<
+    agg_service::WithRawMethod_TickBatchedStreamRequest<
+    agg_service::WithRawMethod_AnalyticsStreamRequest<
+    agg_service::WithAsyncMethod_ListSymbols<agg_service::Service>>>>>;
+
+
 class rpc_handler_base
 {
 public:
@@ -33,11 +67,189 @@ public:
     virtual ~rpc_handler_base() = default;
 };
 
+class tick_request_handler;
+class analytics_request_handler;
+using client_index = subscriber_index<tick_request_handler>;
+using depth_index = depth_views<tick_request_handler>;
+using analytics_index = analytics_views<analytics_request_handler>;
+
+// What the handlers of one completion queue share, all of it touched from
+// that queue's thread only. The symbol registry is shared by every queue.
+struct server_state {
+    server_state(symbol_registry& symbols, client_queue_config queue_config, uint64_t epoch,
+        const replay_config& replay)
+        : symbols(symbols), queue_config(queue_config), epoch(epoch), replay(replay) {}
+
+    symbol_registry& symbols;
+    client_queue_config queue_config;
+    consolidated_books books;
+    client_index clients;
+    depth_index depth;
+    analytics_index analytics;
+    uint64_t published = 0;     // publish_sequence of the last batch
+    uint64_t epoch;             // publish_epoch of the batches, the same on every shard
+    replay_ring replay;
+};
+
+// the publish_epoch of a server: random, never 0
+inline uint64_t make_publish_epoch() {
+    std::random_device device;
+    std::mt19937_64 rng(((uint64_t) device() << 32) | device());
+    return std::uniform_int_distribution<uint64_t>(1, UINT64_MAX)(rng);
+}
+
+inline int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// symbol and symbols are merged. The symbols are those of the link
+// configuration, interned at start-up: a symbol can be subscribed to before
+// its first batch, a name no link maps is NOT_FOUND. Unknown symbol_ids are
+// skipped.
+inline grpc::Status parse_subscription(const tick_request& request, const symbol_registry& symbols, subscription& sub) {
+    sub = subscription();
+    auto add_symbol = [&] (const std::string& name) {
+        symbol_id_t id = symbols.find(name);
+        if (id == invalid_symbol_id)
+            return false;
+        if (std::find(sub.symbols.begin(), sub.symbols.end(), id) == sub.symbols.end())
+            sub.symbols.push_back(id);
+        return true;
+    };
+    if (!request.symbol().empty() && !add_symbol(request.symbol()))
+        return grpc::Status(grpc::StatusCode::NOT_FOUND, "unknown symbol " + request.symbol());
+    for (const auto& name : request.symbols())
+        if (!add_symbol(name))
+            return grpc::Status(grpc::StatusCode::NOT_FOUND, "unknown symbol " + name);
+    size_t known = symbols.size();
+    for (uint32_t id : request.symbol_ids())
+        if (id < known && std::find(sub.symbols.begin(), sub.symbols.end(), id) == sub.symbols.end())
+            sub.symbols.push_back(id);
+    for (uint32_t exchange : request.exchanges())
+        if (std::find(sub.exchanges.begin(), sub.exchanges.end(), exchange) == sub.exchanges.end())
+            sub.exchanges.push_back(exchange);
+    sub.depth = request.depth();
+    return grpc::Status::OK;
+}
+
+// The reply of ListSymbols, without the names asked for that are not
+// symbols. The sizes not configured are those of the decimals seen so far in
+// the batches of the symbol, 0 before the first one.
+inline void list_symbols(const symbol_list_request& request, const symbol_registry& symbols,
+    const consolidated_books& books, symbol_list& reply) {
+    std::vector<symbol_id_t> ids;
+    for (const auto& name : request.symbols())
+        if (symbol_id_t id = symbols.find(name); id != invalid_symbol_id)
+            ids.push_back(id);
+    if (request.symbols().empty())
+        for (symbol_id_t id = 0; id < symbols.size(); ++id)
+            ids.push_back(id);
+    for (symbol_id_t id : ids) {
+        auto& info = *reply.add_symbols();
+        info.set_id(id);
+        info.set_name(symbols.name(id));
+        symbol_sizes sizes = symbols.sizes(id);
+        if (const auto* book = books.find(id)) {
+            if (sizes.tick_size == 0)
+                sizes.tick_size = 1 / wire_codec::power_of_ten(book->scale.price);
+            if (sizes.lot_size == 0)
+                sizes.lot_size = 1 / wire_codec::power_of_ten(book->scale.quantity);
+        }
+        info.set_tick_size(sizes.tick_size);
+        info.set_lot_size(sizes.lot_size);
+    }
+}
+
+// depth streams, and encodings this server does not know, get updates
+inline wire_encoding stream_encoding(const tick_request& request) {
+    if (request.depth() > 0 || !agg_proto::wire_encoding_IsValid(request.encoding()))
+        return agg_proto::encoding_updates;
+    return request.encoding();
+}
+
+// A batch serialized once per encoding, for the first subscriber asking for
+// it: the others queue a reference to the same slices.
+class shared_payload {
+public:
+    shared_payload(const batched_tick_update& ticks, const wire_codec::scale& scale) : ticks_(ticks), scale_(scale) {}
+
+    const grpc::ByteBuffer& get(wire_encoding encoding = agg_proto::encoding_updates) {
+        if (!serialized_[encoding]) {
+            serialize_batch(ticks_, encoding, scale_, payloads_[encoding]);
+            serialized_[encoding] = true;
+            bytes_ += payloads_[encoding].Length();
+        }
+        return payloads_[encoding];
+    }
+
+    // serialized so far, over every encoding
+    size_t bytes() const { return bytes_; }
+
+private:
+    const batched_tick_update& ticks_;
+    const wire_codec::scale& scale_;
+    std::array<grpc::ByteBuffer, agg_proto::wire_encoding_ARRAYSIZE> payloads_;
+    std::array<bool, agg_proto::wire_encoding_ARRAYSIZE> serialized_{};
+    size_t bytes_ = 0;
+};
+
+// Calls send(client, batch, payload) for every subscriber of the batch and
+// returns how many; bytes is what was serialized for them, in the encoding
+// of each (scale: that of the symbol). A batch merged across exchanges goes
+// as is to the streams of every exchange, and split per exchange to the
+// streams restricted to some exchanges.
+template <typename Client, typename Send>
+size_t publish_batch(subscriber_index<Client>& clients, symbol_id_t symbol, const batched_tick_update& ticks,
+    const wire_codec::scale& scale, size_t& bytes, Send&& send) {
+    size_t subscribers = 0;
+    shared_payload payload(ticks, scale);
+    auto send_all = [&] (Client* client) {
+        ++subscribers;
+        send(client, ticks, payload.get(client->encoding()));
+    };
+    if (ticks.exchange() != (uint32_t) exchange_t::undefined) {
+        clients.for_each(symbol, ticks.exchange(), send_all);
+        bytes = payload.bytes();
+        return subscribers;
+    }
+    clients.for_each_all_exchanges(symbol, send_all);
+    bytes = payload.bytes();
+
+    for (uint32_t exchange = 1; exchange < (uint32_t) exchange_t::total; ++exchange) {
+        batched_tick_update part;
+        shared_payload part_payload(part, scale);
+        bool split = false;
+        clients.for_each_exchange_only(symbol, exchange, [&] (Client* client) {
+            if (!split) {
+                part.set_symbol_id(ticks.symbol_id());
+                part.set_exchange(exchange);
+                part.set_tick_id(ticks.tick_id());
+                for (const auto& tick : ticks.updates()) {
+                    if (tick.exchange() != exchange)
+                        continue;
+                    *part.add_updates() = tick;
+                    part.mutable_updates()->rbegin()->clear_exchange();
+                }
+                split = true;
+            }
+            if (part.updates_size() == 0)
+                return;
+            ++subscribers;
+            send(client, part, part_payload.get(client->encoding()));
+        });
+        bytes += part_payload.bytes();
+    }
+    return subscribers;
+}
+
+
 class tick_request_handler : public rpc_handler_base
 {
 public:
-    tick_request_handler(agg_service::AsyncService *service, grpc::ServerCompletionQueue *cq, std::vector<tick_request_handler*>& clients)
-        : service_(service), cq_(cq), writer_(&ctx_), status_(call_status::CREATE), writing_(false), clients_(clients)
+    tick_request_handler(agg_async_service *service, grpc::ServerCompletionQueue *cq, server_state& state)
+        : service_(service), cq_(cq), writer_(&ctx_), status_(call_status::CREATE), state_(state),
+          mq_(state.queue_config)
     {
         proceed(true);
     }
@@ -47,20 +259,52 @@ public:
         if (status_ == call_status::CREATE)
         {
             status_ = call_status::CONNECTED;
-            service_->RequestTickBatchedStreamRequest(&ctx_, &request_, &writer_, cq_, cq_, this);
+            service_->RequestTickBatchedStreamRequest(&ctx_, &request_buffer_, &writer_, cq_, cq_, this);
         }
         else if (status_ == call_status::CONNECTED)
         {
+            if (!ok) {
+                // server shutting down
+                delete this;
+                return;
+            }
             LOG(INFO) << "client connected";
-            new tick_request_handler(service_, cq_, clients_); // Spawn next client handler
-            clients_.push_back(this);
+            new tick_request_handler(service_, cq_, state_); // Spawn next client handler
+            if (!grpc::SerializationTraits<tick_request>::Deserialize(&request_buffer_, &request_).ok()) {
+                finish(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "malformed tick_request"));
+                return;
+            }
+            mq_.set_conflate_levels(request_.conflate());
+            mq_.set_coalesce(request_.coalesce());
+            mq_.set_encoding(stream_encoding(request_));
+            mq_.set_epoch(state_.epoch);
+            if (grpc::Status status = parse_subscription(request_, state_.symbols, subscription_); !status.ok()) {
+                finish(status);
+                return;
+            }
+            if (subscription_.depth > 0 && subscription_.symbols.empty()) {
+                finish(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "depth needs a symbol"));
+                return;
+            }
+            add_client();
             status_ = call_status::IDLE;
+            // queued ahead of any live batch: the stream continues from the snapshot, or the
+            // batches replayed, without a gap
+            if (!resume())
+                send_snapshot();
         }
         else if (status_ == call_status::WRITING) {
             if (ok) {
-                mq_.pop();
-                writing_ = false;
-                try_write();
+                mq_.end_write();
+                if (disconnecting_)
+                    finish(grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED, "client too slow"));
+                else
+                    try_write();
+            } else {
+                // the client is gone
+                LOG(INFO) << "client disconnected";
+                remove_client();
+                delete this;
             }
         }
 
@@ -72,39 +316,381 @@ public:
     }
 
 
-    void finish() {
+    void finish(const grpc::Status& status = grpc::Status::OK) {
         status_ = call_status::FINISH;
-        writer_.Finish(grpc::Status::OK, this);
+        writer_.Finish(status, this);
     }
 
-    void send_update(const batched_tick_update& update) {
-        mq_.push(update);
-        try_write();
+    // payload is ticks serialized, shared with the other clients
+    void send_update(const batched_tick_update& ticks, const grpc::ByteBuffer& payload) {
+        queue(ticks, payload, subscription_.depth > 0 ? 0 : state_.published);
+    }
+
+    size_t queue_depth() const {
+        return mq_.size();
+    }
+
+    wire_encoding encoding() const {
+        return mq_.encoding();
+    }
+
+    const client_queue_stats& stats() const {
+        return mq_.stats();
+    }
+
+    std::string peer() const {
+        return ctx_.peer();
     }
 
 private:
+    // published: the publish_sequence the batch goes out with
+    void queue(const batched_tick_update& ticks, const grpc::ByteBuffer& payload, uint64_t published) {
+        if (disconnecting_ || status_ == call_status::FINISH)
+            return;
+        if (!mq_.push(ticks, payload, published)) {
+            LOG(WARNING) << "client " << ctx_.peer() << " too slow, disconnecting";
+            disconnect();
+            return;
+        }
+        try_write();
+    }
+
+    // A depth stream is fed by one depth view per symbol instead of the
+    // exchange batches.
+    void add_client() {
+        state_.clients.add(this, subscription_);
+        if (subscription_.depth == 0)
+            return;
+        for (symbol_id_t symbol : subscription_.symbols)
+            depth_views_.push_back(&state_.depth.add(this, symbol, subscription_.depth, state_.books.find(symbol)));
+    }
+
+    // The batches published since request.resume_from, as they went to the
+    // streams then, if the replay ring still has every one of them. Depth
+    // streams, and those resuming from another epoch, start from a snapshot.
+    bool resume() {
+        uint64_t from = request_.resume_from();
+        if (from == 0 || subscription_.depth > 0)
+            return false;
+        if (request_.resume_epoch() != state_.epoch) {
+            LOG(INFO) << "client resuming from another server, or before a restart: snapshot";
+            return false;
+        }
+        if (!state_.replay.covers(from, state_.published, steady_now_ns()))
+            return false;
+        subscriber_index<tick_request_handler> self;
+        self.add(this, subscription_);
+        state_.replay.replay(from, [&] (const replay_ring::entry& e) {
+            size_t bytes = 0;
+            publish_batch(self, e.symbol, e.ticks, state_.books.find(e.symbol)->scale, bytes,
+                [&] (tick_request_handler*, const batched_tick_update& batch, const grpc::ByteBuffer& payload) {
+                    queue(batch, payload, e.sequence);
+                });
+        });
+        return true;
+    }
+
+    void send_snapshot() {
+        std::vector<batched_tick_update> batches;
+        if (subscription_.depth > 0) {
+            for (const depth_view* view : depth_views_) {
+                if (view->empty())
+                    continue;
+                batches.emplace_back();
+                view->snapshot(batches.back());
+            }
+        } else if (subscription_.symbols.empty()) {
+            state_.books.snapshot_all(batches);
+        } else {
+            for (symbol_id_t symbol : subscription_.symbols)
+                state_.books.snapshot(symbol, batches);
+        }
+
+        for (const auto& ticks : batches) {
+            if (subscription_.depth == 0 && !subscription_.wants(ticks.exchange()))
+                continue;
+            grpc::ByteBuffer payload;
+            serialize_batch(ticks, mq_.encoding(), payload);
+            send_update(ticks, payload);
+        }
+    }
 
     void remove_client() {
-        auto it = std::find(clients_.begin(), clients_.end(), this);
-            if (it != clients_.end()) clients_.erase(it);        
+        state_.clients.remove(this, subscription_);
+        for (const depth_view* view : depth_views_)
+            state_.depth.remove(this, view->symbol(), view->depth());
+        depth_views_.clear();
     }
+
+    // stop queueing, finish once the write in flight (if any) completes
+    void disconnect() {
+        remove_client();
+        mq_.clear();
+        if (mq_.writing())
+            disconnecting_ = true;
+        else
+            finish(grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED, "client too slow"));
+    }
+
     void try_write() {
-        if (!writing_ && !mq_.empty()) {
-            writing_ = true;
+        if (!mq_.writing() && !mq_.empty()) {
             status_ = call_status::WRITING;
 
-            writer_.Write(mq_.front(), this);
+            writer_.Write(mq_.begin_write(), this);
         }
         if (mq_.empty())
             status_ = call_status::IDLE;
     }
 
 
-    agg_service::AsyncService *service_;
+    agg_async_service *service_;
     grpc::ServerCompletionQueue *cq_;
     grpc::ServerContext ctx_;
+    grpc::ByteBuffer request_buffer_;
     tick_request request_;
-    grpc::ServerAsyncWriter<batched_tick_update> writer_;
+    grpc::ServerAsyncWriter<grpc::ByteBuffer> writer_;
+    enum class call_status
+    {
+        CREATE,
+        CONNECTED,
+        IDLE,
+        WRITING,
+        FINISH
+    };
+    call_status status_;
+    server_state& state_;
+    subscription subscription_;
+    std::vector<const depth_view*> depth_views_;
+    client_queue mq_;
+    bool disconnecting_ = false;
+};
+
+
+// Unary TickSnapshotRequest: the consolidated book of one symbol, or all of them.
+class snapshot_request_handler : public rpc_handler_base
+{
+public:
+    snapshot_request_handler(agg_async_service *service, grpc::ServerCompletionQueue *cq, const server_state& state)
+        : service_(service), cq_(cq), responder_(&ctx_), status_(call_status::CREATE), state_(state)
+    {
+        proceed(true);
+    }
+
+    void proceed(bool ok) override
+    {
+        if (status_ == call_status::CREATE)
+        {
+            status_ = call_status::PROCESS;
+            service_->RequestTickSnapshotRequest(&ctx_, &request_, &responder_, cq_, cq_, this);
+        }
+        else if (status_ == call_status::PROCESS)
+        {
+            if (!ok) {
+                // server shutting down
+                delete this;
+                return;
+            }
+            new snapshot_request_handler(service_, cq_, state_);
+            status_ = call_status::FINISH;
+            std::vector<batched_tick_update> batches;
+            if (request_.symbol().empty()) {
+                state_.books.snapshot_all(batches);
+            } else {
+                symbol_id_t symbol = state_.symbols.find(request_.symbol());
+                if (!state_.books.find(symbol)) {
+                    responder_.FinishWithError(grpc::Status(grpc::StatusCode::NOT_FOUND, "unknown symbol " + request_.symbol()), this);
+                    return;
+                }
+                state_.books.snapshot(symbol, batches);
+            }
+            tick_snapshot reply;
+            for (auto& ticks : batches)
+                *reply.add_books() = std::move(ticks);
+            reply.set_publish_sequence(state_.published);
+            reply.set_publish_epoch(state_.epoch);
+            responder_.Finish(reply, grpc::Status::OK, this);
+        }
+        else
+        {
+            delete this;
+        }
+    }
+
+private:
+    agg_async_service *service_;
+    grpc::ServerCompletionQueue *cq_;
+    grpc::ServerContext ctx_;
+    tick_request request_;
+    grpc::ServerAsyncResponseWriter<tick_snapshot> responder_;
+    enum class call_status
+    {
+        CREATE,
+        PROCESS,
+        FINISH
+    };
+    call_status status_;
+    const server_state& state_;
+};
+
+
+// Unary ListSymbols: the ids the streams carry, with the name and sizes of
+// each symbol.
+class symbol_list_handler : public rpc_handler_base
+{
+public:
+    symbol_list_handler(agg_async_service *service, grpc::ServerCompletionQueue *cq, const server_state& state)
+        : service_(service), cq_(cq), responder_(&ctx_), status_(call_status::CREATE), state_(state)
+    {
+        proceed(true);
+    }
+
+    void proceed(bool ok) override
+    {
+        if (status_ == call_status::CREATE)
+        {
+            status_ = call_status::PROCESS;
+            service_->RequestListSymbols(&ctx_, &request_, &responder_, cq_, cq_, this);
+        }
+        else if (status_ == call_status::PROCESS)
+        {
+            if (!ok) {
+                // server shutting down
+                delete this;
+                return;
+            }
+            new symbol_list_handler(service_, cq_, state_);
+            status_ = call_status::FINISH;
+            symbol_list reply;
+            list_symbols(request_, state_.symbols, state_.books, reply);
+            reply.set_publish_epoch(state_.epoch);
+            responder_.Finish(reply, grpc::Status::OK, this);
+        }
+        else
+        {
+            delete this;
+        }
+    }
+
+private:
+    agg_async_service *service_;
+    grpc::ServerCompletionQueue *cq_;
+    grpc::ServerContext ctx_;
+    symbol_list_request request_;
+    grpc::ServerAsyncResponseWriter<symbol_list> responder_;
+    enum class call_status
+    {
+        CREATE,
+        PROCESS,
+        FINISH
+    };
+    call_status status_;
+    const server_state& state_;
+};
+
+
+// Server-streaming AnalyticsStreamRequest. Only the latest figures matter:
+// while a write is in flight, a newer update replaces the pending one.
+class analytics_request_handler : public rpc_handler_base
+{
+public:
+    analytics_request_handler(agg_async_service *service, grpc::ServerCompletionQueue *cq, server_state& state)
+        : service_(service), cq_(cq), writer_(&ctx_), status_(call_status::CREATE), state_(state)
+    {
+        proceed(true);
+    }
+
+    void proceed(bool ok) override
+    {
+        if (status_ == call_status::CREATE)
+        {
+            status_ = call_status::CONNECTED;
+            service_->RequestAnalyticsStreamRequest(&ctx_, &request_buffer_, &writer_, cq_, cq_, this);
+        }
+        else if (status_ == call_status::CONNECTED)
+        {
+            if (!ok) {
+                // server shutting down
+                delete this;
+                return;
+            }
+            LOG(INFO) << "analytics client connected";
+            new analytics_request_handler(service_, cq_, state_);
+            if (!grpc::SerializationTraits<analytics_request>::Deserialize(&request_buffer_, &request_).ok()) {
+                finish(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "malformed analytics_request"));
+                return;
+            }
+            if (request_.symbol().empty()) {
+                finish(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "analytics need a symbol"));
+                return;
+            }
+            symbol_id_t symbol = state_.symbols.find(request_.symbol());
+            if (symbol == invalid_symbol_id) {
+                finish(grpc::Status(grpc::StatusCode::NOT_FOUND, "unknown symbol " + request_.symbol()));
+                return;
+            }
+            view_ = &state_.analytics.add(this, symbol, request_, state_.books.find(symbol));
+            status_ = call_status::IDLE;
+            if (view_->computed()) {
+                grpc::ByteBuffer payload;
+                bool own_buffer;
+                grpc::SerializationTraits<analytics_update>::Serialize(view_->last(), &payload, &own_buffer);
+                send_update(payload);
+            }
+        }
+        else if (status_ == call_status::WRITING)
+        {
+            if (ok) {
+                status_ = call_status::IDLE;
+                try_write();
+            } else {
+                LOG(INFO) << "analytics client disconnected";
+                remove_client();
+                delete this;
+            }
+        }
+        else if (status_ == call_status::FINISH)
+        {
+            remove_client();
+            delete this;
+        }
+    }
+
+    // payload is an analytics_update, shared with the other clients of the view
+    void send_update(const grpc::ByteBuffer& payload) {
+        if (status_ == call_status::FINISH)
+            return;
+        pending_ = payload;
+        has_pending_ = true;
+        try_write();
+    }
+
+private:
+    void finish(const grpc::Status& status) {
+        status_ = call_status::FINISH;
+        writer_.Finish(status, this);
+    }
+
+    void try_write() {
+        if (status_ != call_status::IDLE || !has_pending_)
+            return;
+        status_ = call_status::WRITING;
+        writing_ = pending_;
+        has_pending_ = false;
+        writer_.Write(writing_, this);
+    }
+
+    void remove_client() {
+        if (view_)
+            state_.analytics.remove(this, view_);
+        view_ = nullptr;
+    }
+
+    agg_async_service *service_;
+    grpc::ServerCompletionQueue *cq_;
+    grpc::ServerContext ctx_;
+    grpc::ByteBuffer request_buffer_;
+    analytics_request request_;
+    grpc::ServerAsyncWriter<grpc::ByteBuffer> writer_;
     enum class call_status
     {
         CREATE,
@@ -114,19 +700,277 @@ private:
         FINISH
     };
     call_status status_;
-    std::vector<tick_request_handler*>& clients_;
-    std::queue<batched_tick_update> mq_;
-    bool writing_;
+    server_state& state_;
+    const analytics_view* view_ = nullptr;
+    grpc::ByteBuffer pending_;
+    bool has_pending_ = false;
+    grpc::ByteBuffer writing_;
+};
+
+
+// A batch handed to the completion queue threads. The ring slots are reused
+// and so are the repeated fields of ticks.
+struct published_batch {
+    symbol_id_t symbol = 0;
+    batched_tick_update ticks;
 };
 
 
+// One completion queue with its own handlers, books and views. A shard
+// serves the streams gRPC hands to its queue; with several shards each of
+// them sees every batch and keeps its own consolidated books, so nothing is
+// shared between the queue threads but the symbol registry.
+class server_shard
+{
+public:
+    // bbo: the table this shard writes the best bid / ask of each book to as
+    // it changes, one shard only, nullptr for none
+    server_shard(agg_async_service *service, std::unique_ptr<grpc::ServerCompletionQueue> cq,
+        symbol_registry& symbols, client_queue_config queue_config, uint64_t epoch, const replay_config& replay,
+        shm_bbo::writer* bbo)
+        : service_(service), cq_(std::move(cq)), state_(symbols, queue_config, epoch, replay), wakeup_(*this),
+          bbo_(bbo) {}
+
+    // once the server is started
+    void start() {
+        new tick_request_handler(service_, cq_.get(), state_);
+        new snapshot_request_handler(service_, cq_.get(), state_);
+        new analytics_request_handler(service_, cq_.get(), state_);
+        new symbol_list_handler(service_, cq_.get(), state_);
+    }
+
+    // after the server shutdown: runs what is left on the queue
+    void shutdown() {
+        shutdown_queue();
+        void *tag;
+        bool ok;
+        while (cq_->Next(&tag, &ok))
+            static_cast<rpc_handler_base *>(tag)->proceed(ok);
+        release_clients();
+    }
+
+    void shutdown_queue() {
+        cq_->Shutdown();
+    }
+
+    // once the queue is drained
+    void release_clients() {
+        // idle clients have no pending operation left on the queue
+        auto idle = state_.clients.all();
+        for (auto* client : idle) {
+            delete client;
+        }
+        for (auto* client : state_.analytics.subscribers()) {
+            delete client;
+        }
+    }
+
+    void poll_block()
+    {
+        void *tag;
+        bool ok;
+        if (cq_->Next(&tag, &ok))
+            proceed(tag, ok);
+    }
+
+    // false if there was no event
+    bool poll_non_block()
+    {
+        void *tag;
+        bool ok;
+        // an already expired deadline: "now" still waits for the next tick of the timer
+        auto status = cq_->AsyncNext(&tag, &ok, gpr_inf_past(GPR_CLOCK_MONOTONIC));
+        if (status != grpc::CompletionQueue::GOT_EVENT)
+            return false;
+        proceed(tag, ok);
+        return true;
+    }
 
+    // The queue thread of a threaded server: batches come from the ring,
+    // the thread blocks on the queue and is woken up by wake(). Returns
+    // once the queue is shut down.
+    void run(broadcast_ring<published_batch>& ring, size_t consumer) {
+        ring_ = &ring;
+        consumer_ = consumer;
+        void *tag;
+        bool ok;
+        while (cq_->Next(&tag, &ok))
+            proceed(tag, ok);
+    }
+
+    // From any thread: drain the ring on the queue thread. The fence pairs
+    // with that of drain_ring: the batch pushed before is seen by the drain
+    // running, or the flag it cleared is seen here and the alarm set again.
+    void wake() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!wake_pending_.exchange(true, std::memory_order_acq_rel))
+            alarm_.Set(cq_.get(), gpr_inf_past(GPR_CLOCK_MONOTONIC), &wakeup_);
+    }
+
+    // from any thread: log the client stats on the queue thread
+    void request_stats() {
+        stats_requested_.store(true, std::memory_order_release);
+        wake();
+    }
+
+    // Every shard sees the same batches in the same order, so numbers them the same
+    void process_tick(symbol_id_t symbol_id, const batched_tick_update& ticks) {
+        ++state_.published;
+        state_.replay.add(state_.published, symbol_id, ticks, steady_now_ns());
+        state_.books.update(symbol_id, ticks);
+        const auto& book = *state_.books.find(symbol_id);
+        if (bbo_)
+            write_bbo(symbol_id, book.book, ticks.tick_id());
+        state_.depth.publish(symbol_id, book, ticks.tick_id(),
+            [] (tick_request_handler* client, const batched_tick_update& changes, const grpc::ByteBuffer& payload) {
+                client->send_update(changes, payload);
+            });
+        state_.analytics.publish(symbol_id, book, ticks.tick_id(),
+            [] (analytics_request_handler* client, const grpc::ByteBuffer& payload) {
+                client->send_update(payload);
+            });
+
+        size_t bytes = 0;
+        size_t subscribers = publish_batch(state_.clients, symbol_id, ticks, book.scale, bytes,
+            [] (tick_request_handler* client, const batched_tick_update& batch, const grpc::ByteBuffer& payload) {
+                client->send_update(batch, payload);
+            });
+        if (subscribers == 0)
+            return;
+
+        if (binlog::enabled())
+            BINLOG("To client: symbol {} exchange {} tick_id {} updates {} clients {} bytes {}",
+                symbol_id, ticks.exchange(), ticks.tick_id(), ticks.updates_size(), subscribers, bytes);
+        else
+            LOG_RATE_LIMITED(INFO, hot_path_log_rate) << "To client:" << ticks.ShortDebugString();
+    }
 
+    const server_state& state() const {
+        return state_;
+    }
+
+    // tick streams connected, readable from any thread
+    size_t streams() const {
+        return streams_.load(std::memory_order_relaxed);
+    }
+
+    void log_client_stats() const {
+        for (auto* client : state_.clients.all()) {
+            const client_queue_stats& s = client->stats();
+            LOG(INFO) << "client " << client->peer() << ": depth " << s.depth << " max depth " << s.max_depth
+                      << " queued " << s.queued << " written " << s.written
+                      << " dropped " << s.dropped << " conflated " << s.conflated
+                      << " writes " << s.writes << " batches per write " << s.write_size_distribution();
+        }
+        if (state_.replay.enabled()) {
+            const replay_ring_stats& s = state_.replay.stats();
+            LOG(INFO) << "replay ring: batches " << s.batches << " bytes " << s.bytes << " resumed " << s.hits
+                      << " snapshots " << s.misses << " batches replayed " << s.replayed;
+        }
+    }
+
+private:
+    struct ring_wakeup : rpc_handler_base {
+        explicit ring_wakeup(server_shard& shard) : shard(shard) {}
+        void proceed(bool) override { shard.drain_ring(); }
+        server_shard& shard;
+    };
+
+    void proceed(void *tag, bool ok) {
+        static_cast<rpc_handler_base *>(tag)->proceed(ok);
+        streams_.store(state_.clients.all().size(), std::memory_order_relaxed);
+    }
+
+    void write_bbo(symbol_id_t symbol_id, const order_book::extended_book& book, int64_t tick_id) {
+        if (!bbo_->fits(symbol_id)) {
+            LOG_RATE_LIMITED(WARNING, hot_path_log_rate) << "symbol " << symbol_id
+                << " beyond the shared memory bbo table, not written";
+            return;
+        }
+        if (!bbo_->named(symbol_id))
+            bbo_->name(symbol_id, state_.symbols.name(symbol_id));
+        shm_bbo::quote q;
+        auto bid = book.best_bid();
+        auto ask = book.best_ask();
+        q.bid.price = bid.price;
+        q.ask.price = ask.price;
+        std::copy(std::begin(bid.qty), std::end(bid.qty), q.bid.qty);
+        std::copy(std::begin(ask.qty), std::end(ask.qty), q.ask.qty);
+        q.tick_id = tick_id;
+        q.publish_sequence = state_.published;
+        bbo_->update(symbol_id, q);
+    }
+
+    void drain_ring() {
+        // cleared first: a batch published from now on sets the alarm again
+        wake_pending_.store(false, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (ring_)
+            ring_->consume(consumer_, [this] (const published_batch& batch) {
+                process_tick(batch.symbol, batch.ticks);
+            });
+        if (stats_requested_.exchange(false, std::memory_order_acq_rel))
+            log_client_stats();
+    }
+
+    agg_async_service *service_;
+    std::unique_ptr<grpc::ServerCompletionQueue> cq_;
+    server_state state_;
+    std::atomic<size_t> streams_{0};
+
+    broadcast_ring<published_batch>* ring_ = nullptr;
+    size_t consumer_ = 0;
+    grpc::Alarm alarm_;
+    ring_wakeup wakeup_;
+    std::atomic<bool> wake_pending_{false};
+    std::atomic<bool> stats_requested_{false};
+    shm_bbo::writer* bbo_ = nullptr;
+};
+
+
+// What the server does besides the streams. Given to the constructor: the
+// streams and the queue threads use it as soon as the server listens.
+struct aggregator_server_config {
+    size_t ring_size = 4096;            // batches in flight to the queue threads
+    // Merges the batches of a symbol coming from several exchanges within a
+    // window, see batch_window.
+    batch_window_config batch_window;
+    // Keeps the batches published last for the streams resuming with
+    // tick_request.resume_from, one ring per queue.
+    replay_config replay;
+    // Writes every batch published, as updates, to this shared memory ring
+    // for the clients on this host (base_client::subscribe_shm), from the
+    // thread calling process_tick. None if empty.
+    std::string shm_ring_name;
+    shm_ring::config shm_ring_config;
+    // Keeps the consolidated best bid / ask of every symbol, with the
+    // quantity of each exchange, in this shared memory table for the
+    // processes on this host (shm_bbo::reader), of shm_bbo_symbols entries.
+    // Written by the first queue after it applies a batch. None if empty.
+    std::string shm_bbo_name;
+    size_t shm_bbo_symbols = 1024;
+};
+
+
+// With threads == 0 the server has a single completion queue, driven by the
+// caller through poll_block() / poll_non_block() on the thread that also
+// calls process_tick(). With threads > 0 it has one completion queue per
+// thread: the streams are spread over the queues by gRPC, process_tick()
+// hands each batch to every queue thread through a lock-free broadcast ring,
+// and poll_* must not be called.
+// Throws std::runtime_error if a shared memory ring or table of config
+// cannot be opened.
 class aggregator_server
 {
 public:
-    aggregator_server(uint16_t port)
+    aggregator_server(uint16_t port, symbol_registry& symbols, client_queue_config queue_config = {},
+        size_t threads = 0, const aggregator_server_config& config = {})
+        : window_(config.batch_window)
     {
+        if (!config.shm_ring_name.empty() && !shm_.open(config.shm_ring_name, config.shm_ring_config))
+            throw std::runtime_error("cannot open the shared memory ring " + config.shm_ring_name);
+        if (!config.shm_bbo_name.empty() && !bbo_.open(config.shm_bbo_name, config.shm_bbo_symbols))
+            throw std::runtime_error("cannot open the shared memory bbo table " + config.shm_bbo_name);
         std::string server_address = absl::StrFormat("0.0.0.0:%d", port);
 
         grpc::EnableDefaultHealthCheckService(true);
@@ -134,47 +978,142 @@ public:
 
         builder_.AddListeningPort(server_address, grpc::InsecureServerCredentials());
         builder_.RegisterService(&service_);
-        cq_ = builder_.AddCompletionQueue();
+        uint64_t epoch = make_publish_epoch();
+        for (size_t i = 0; i < std::max<size_t>(1, threads); ++i)
+            shards_.push_back(std::make_unique<server_shard>(&service_, builder_.AddCompletionQueue(), symbols, queue_config,
+                epoch, config.replay, i == 0 && bbo_.is_open() ? &bbo_ : nullptr));
 
         server_ = builder_.BuildAndStart();
         std::cout << "Server listening on " << server_address << std::endl;
-        new tick_request_handler(&service_, cq_.get(), clients_);
+        for (auto& shard : shards_)
+            shard->start();
+
+        if (threads == 0)
+            return;
+        ring_ = std::make_unique<broadcast_ring<published_batch>>(config.ring_size, threads);
+        for (size_t i = 0; i < threads; ++i)
+            threads_.emplace_back([this, i] { shards_[i]->run(*ring_, i); });
     }
 
-    // Poll for gRPC events
-    void poll_block()
+    ~aggregator_server()
     {
-        void *tag;
-        bool ok;
-        if (cq_->Next(&tag, &ok))
-        {
-            static_cast<rpc_handler_base *>(tag)->proceed(ok);
+        server_->Shutdown(std::chrono::system_clock::now());
+        if (threads_.empty()) {
+            shards_[0]->shutdown();
+            return;
         }
+        // the queue threads return once their queue is shut down and drained
+        for (auto& shard : shards_)
+            shard->shutdown_queue();
+        for (auto& thread : threads_)
+            thread.join();
+        for (auto& shard : shards_)
+            shard->release_clients();
+    }
+
+    // Poll for gRPC events, single queue only
+    void poll_block()
+    {
+        shards_[0]->poll_block();
     }
 
     void poll_non_block()
     {
-        void *tag;
-        bool ok;
-        auto now = std::chrono::system_clock::now();
-        auto status = cq_->AsyncNext(&tag, &ok, now);
-        if (status == grpc::CompletionQueue::GOT_EVENT)
-        {
-            static_cast<rpc_handler_base *>(tag)->proceed(ok);
+        shards_[0]->poll_non_block();
+    }
+
+
+    void process_tick(symbol_id_t symbol_id, const batched_tick_update& ticks) {
+        if (!window_.enabled()) {
+            publish(symbol_id, ticks);
+            return;
         }
+        window_.add(symbol_id, ticks, steady_now_ns(), [this] (symbol_id_t symbol, const batched_tick_update& batch) {
+            publish(symbol, batch);
+        });
+    }
+
+    // publishes the batch windows that ended, from the thread calling process_tick
+    void poll_batch_window() {
+        if (window_.enabled())
+            window_.poll(steady_now_ns(), [this] (symbol_id_t symbol, const batched_tick_update& batch) {
+                publish(symbol, batch);
+            });
+    }
+
+    const batch_window_stats& window_stats() const {
+        return window_.stats();
     }
 
+    // the accessors below read the first queue: the whole server unless threaded
 
-    void process_tick(const batched_tick_update& ticks) {
-        LOG(INFO) << "To client:" << ticks.ShortDebugString();
-        for (auto* client : clients_) {
-            client->send_update(ticks);
+    const std::vector<tick_request_handler*>& clients() const {
+        return shards_[0]->state().clients.all();
+    }
+
+    const consolidated_books& books() const {
+        return shards_[0]->state().books;
+    }
+
+    // number of distinct (symbol, depth) views being published
+    size_t depth_views() const {
+        return shards_[0]->state().depth.size();
+    }
+
+    // number of distinct (symbol, parameters) analytics views being published
+    size_t analytics_views() const {
+        return shards_[0]->state().analytics.size();
+    }
+
+    size_t analytics_clients() const {
+        return shards_[0]->state().analytics.subscribers().size();
+    }
+
+    const replay_ring_stats& replay_stats() const {
+        return shards_[0]->state().replay.stats();
+    }
+
+    // the publish_epoch of the batches, drawn as the server started
+    uint64_t publish_epoch() const {
+        return shards_[0]->state().epoch;
+    }
+
+    // analytics computed so far, over every view
+    uint64_t analytics_computations() const {
+        return shards_[0]->state().analytics.computations();
+    }
+
+    // tick streams connected over every queue, from any thread
+    size_t streams() const {
+        size_t n = 0;
+        for (const auto& shard : shards_)
+            n += shard->streams();
+        return n;
+    }
+
+    size_t queues() const {
+        return shards_.size();
+    }
+
+    void log_client_stats() const {
+        if (window_.enabled()) {
+            const batch_window_stats& s = window_.stats();
+            LOG(INFO) << "batch window: batches in " << s.batches_in << " out " << s.batches_out
+                      << " merged " << s.merged;
+        }
+        if (uint64_t dropped = binlog::stats::dropped.load(std::memory_order_relaxed))
+            LOG(WARNING) << "binary log: dropped " << dropped << " events";
+        if (threads_.empty()) {
+            shards_[0]->log_client_stats();
+            return;
         }
+        for (const auto& shard : shards_)
+            shard->request_stats();
     }
-    
-    std::function<void(const batched_tick_update&)> get_process_ticks() {
-        return [this] (const batched_tick_update& ticks) {
-            return this->process_tick(ticks);
+
+    std::function<void(symbol_id_t, const batched_tick_update&)> get_process_ticks() {
+        return [this] (symbol_id_t symbol_id, const batched_tick_update& ticks) {
+            return this->process_tick(symbol_id, ticks);
         };
     }
 
@@ -182,13 +1121,41 @@ public:
 
 
 private:
+    void publish(symbol_id_t symbol_id, const batched_tick_update& ticks) {
+        if (shm_.is_open())
+            write_shm(ticks);
+        if (!ring_) {
+            shards_[0]->process_tick(symbol_id, ticks);
+            return;
+        }
+        ring_->publish([&] (published_batch& batch) {
+            batch.symbol = symbol_id;
+            batch.ticks.CopyFrom(ticks);
+        });
+        for (auto& shard : shards_)
+            shard->wake();
+    }
 
+    void write_shm(const batched_tick_update& ticks) {
+        size_t size = ticks.ByteSizeLong();
+        bool written = shm_.write(size, [&] (char* data) {
+            ticks.SerializeWithCachedSizesToArray(reinterpret_cast<uint8_t*>(data));
+        });
+        if (!written) {
+            LOG_RATE_LIMITED(WARNING, hot_path_log_rate) << "batch of " << size
+                << " bytes larger than the shared memory slots, marked dropped";
+        }
+    }
 
-    agg_service::AsyncService service_;
+    agg_async_service service_;
     grpc::ServerBuilder builder_;
-    std::unique_ptr<grpc::ServerCompletionQueue> cq_;
     std::unique_ptr<grpc::Server> server_;
-    std::vector<tick_request_handler*> clients_;
+    std::vector<std::unique_ptr<server_shard>> shards_;
+    std::unique_ptr<broadcast_ring<published_batch>> ring_;
+    std::vector<std::thread> threads_;
+    batch_window window_;
+    shm_ring::writer shm_;
+    shm_bbo::writer bbo_;
 };
 
 
@@ -0,0 +1,209 @@
+#ifndef _ANALYTICS_VIEWS_H_
+#define _ANALYTICS_VIEWS_H_
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+#include "../common.h"
+#include "../protos/aggregator.grpc.pb.h"
+#include "../symbol_registry.h"
+#include "consolidated_books.h"
+
+using agg_proto::analytics_request;
+using agg_proto::analytics_update;
+
+
+// The analytics of one symbol for one parameter set: best bid / ask, and the
+// volume and price bands if asked for, computed the way client1, client2
+// and client3 do from their own books.
+class analytics_view {
+public:
+    analytics_view(symbol_id_t symbol, const analytics_request& params)
+        : symbol_(symbol),
+          name_(params.symbol()),
+          volume_bands_(params.volume_bands().begin(), params.volume_bands().end()),
+          price_bands_(params.price_bands().begin(), params.price_bands().end()) {}
+
+    symbol_id_t symbol() const { return symbol_; }
+
+    bool matches(const analytics_request& params) const {
+        return std::equal(volume_bands_.begin(), volume_bands_.end(),
+                          params.volume_bands().begin(), params.volume_bands().end())
+            && std::equal(price_bands_.begin(), price_bands_.end(),
+                          params.price_bands().begin(), params.price_bands().end());
+    }
+
+    // recomputes from the book, false if nothing changed since the last call
+    bool update(const consolidated_books::symbol_book& book, int64_t tick_id) {
+        const auto& b = book.book;
+        auto bid = b.best_bid();
+        auto ask = b.best_ask();
+        figures next{bid.price, bid.qty[0], ask.price, ask.qty[0]};
+        if (!volume_bands_.empty()) {
+            next.bid_volume_bands = b.volume_band_bids(volume_bands_);
+            next.ask_volume_bands = b.volume_band_asks(volume_bands_);
+        }
+        if (!price_bands_.empty()) {
+            next.bid_price_bands = order_book::extended_book::price_band(bid.price, price_bands_);
+            next.ask_price_bands = order_book::extended_book::price_band(ask.price, price_bands_);
+        }
+        ++computations_;
+        if (computed_ && next.same(figures_))
+            return false;
+        figures_ = std::move(next);
+        computed_ = true;
+
+        last_.Clear();
+        last_.set_symbol(name_);
+        last_.set_tick_id(tick_id);
+        last_.set_best_bid(figures_.best_bid);
+        last_.set_best_bid_quantity(figures_.best_bid_quantity);
+        last_.set_best_ask(figures_.best_ask);
+        last_.set_best_ask_quantity(figures_.best_ask_quantity);
+        for (double price : figures_.bid_volume_bands)
+            last_.add_bid_volume_bands(price);
+        for (double price : figures_.ask_volume_bands)
+            last_.add_ask_volume_bands(price);
+        for (double price : figures_.bid_price_bands)
+            last_.add_bid_price_bands(price);
+        for (double price : figures_.ask_price_bands)
+            last_.add_ask_price_bands(price);
+        return true;
+    }
+
+    bool computed() const { return computed_; }
+    const analytics_update& last() const { return last_; }
+    uint64_t computations() const { return computations_; }
+
+private:
+    // what update computes, compared as is rather than serialized
+    struct figures {
+        double best_bid = 0;
+        double best_bid_quantity = 0;
+        double best_ask = 0;
+        double best_ask_quantity = 0;
+        std::vector<double> bid_volume_bands;
+        std::vector<double> ask_volume_bands;
+        std::vector<double> bid_price_bands;
+        std::vector<double> ask_price_bands;
+
+        bool same(const figures& o) const {
+            return std::tie(best_bid, best_bid_quantity, best_ask, best_ask_quantity,
+                            bid_volume_bands, ask_volume_bands, bid_price_bands, ask_price_bands)
+                == std::tie(o.best_bid, o.best_bid_quantity, o.best_ask, o.best_ask_quantity,
+                            o.bid_volume_bands, o.ask_volume_bands, o.bid_price_bands, o.ask_price_bands);
+        }
+    };
+
+    symbol_id_t symbol_;
+    std::string name_;
+    std::vector<double> volume_bands_;
+    std::vector<int> price_bands_;
+    figures figures_;
+    analytics_update last_;
+    bool computed_ = false;
+    uint64_t computations_ = 0;
+};
+
+
+// The analytics views with at least one subscriber. Streams asking for the
+// same parameters on the same symbol share a view: each book change costs
+// one computation and one serialization per distinct parameter set, however
+// many clients asked for it.
+template <typename Client>
+class analytics_views {
+public:
+    // the view the client now receives, to take its first update from
+    const analytics_view& add(Client* client, symbol_id_t symbol, const analytics_request& params,
+        const consolidated_books::symbol_book* book) {
+        entry& e = find_or_add(symbol, params);
+        if (e.subscribers.empty() && book)
+            e.view->update(*book, e.tick_id);   // not updated while nobody listened
+        e.subscribers.push_back(client);
+        return *e.view;
+    }
+
+    void remove(Client* client, const analytics_view* view) {
+        if (view->symbol() >= symbols_.size())
+            return;
+        for (entry& e : symbols_[view->symbol()]) {
+            if (e.view.get() != view)
+                continue;
+            auto it = std::find(e.subscribers.begin(), e.subscribers.end(), client);
+            if (it != e.subscribers.end())
+                e.subscribers.erase(it);
+        }
+    }
+
+    // Calls send(client, payload) for every subscriber of a view of the
+    // symbol whose figures changed. Backwards, so send may remove the client
+    // it is called on; views are kept when their last subscriber leaves.
+    template <typename F>
+    void publish(symbol_id_t symbol, const consolidated_books::symbol_book& book, int64_t tick_id, F&& send) {
+        if (symbol >= symbols_.size())
+            return;
+        for (entry& e : symbols_[symbol]) {
+            e.tick_id = tick_id;
+            if (e.subscribers.empty() || !e.view->update(book, tick_id))
+                continue;
+            grpc::ByteBuffer payload;
+            bool own_buffer;
+            grpc::SerializationTraits<analytics_update>::Serialize(e.view->last(), &payload, &own_buffer);
+            for (size_t i = e.subscribers.size(); i-- > 0;)
+                send(e.subscribers[i], payload);
+        }
+    }
+
+    std::vector<Client*> subscribers() const {
+        std::vector<Client*> all;
+        for (const auto& views : symbols_)
+            for (const auto& e : views)
+                all.insert(all.end(), e.subscribers.begin(), e.subscribers.end());
+        return all;
+    }
+
+    // number of views with at least one subscriber
+    size_t size() const {
+        size_t n = 0;
+        for (const auto& views : symbols_)
+            for (const auto& e : views)
+                n += !e.subscribers.empty();
+        return n;
+    }
+
+    uint64_t computations() const {
+        uint64_t n = 0;
+        for (const auto& views : symbols_)
+            for (const auto& e : views)
+                n += e.view->computations();
+        return n;
+    }
+
+private:
+    struct entry {
+        std::unique_ptr<analytics_view> view;
+        std::vector<Client*> subscribers;
+        int64_t tick_id = 0;    // last batch of the symbol
+    };
+
+    entry& find_or_add(symbol_id_t symbol, const analytics_request& params) {
+        if (symbol >= symbols_.size())
+            symbols_.resize(symbol + 1);
+        auto& views = symbols_[symbol];
+        for (entry& e : views)
+            if (e.view->matches(params))
+                return e;
+        views.push_back({std::make_unique<analytics_view>(symbol, params), {}, 0});
+        return views.back();
+    }
+
+    std::vector<std::vector<entry>> symbols_;   // by symbol id
+};
+
+
+#endif  // _ANALYTICS_VIEWS_H_
@@ -0,0 +1,128 @@
+#ifndef _BATCH_WINDOW_H_
+#define _BATCH_WINDOW_H_
+
+#include <stdint.h>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "../common.h"
+#include "../protos/aggregator.grpc.pb.h"
+#include "../symbol_registry.h"
+
+using agg_proto::batched_tick_update;
+
+
+struct batch_window_config {
+    int64_t window_us = 0;      // 0: every batch is published as it comes
+    size_t max_updates = 1000;  // published before the window ends once that many updates are pending
+};
+
+struct batch_window_stats {
+    uint64_t batches_in = 0;
+    uint64_t batches_out = 0;
+    uint64_t merged = 0;        // batches out carrying several exchanges
+};
+
+
+// Micro-batching of the exchange batches, per symbol. The first batch of a
+// symbol opens a window of window_us; what comes for that symbol before it
+// ends, or before max_updates are pending, goes out as one batch. Batches of
+// one exchange only stay a batch of that exchange; batches of several
+// exchanges become one batch of exchange 0 whose updates each carry their
+// exchange. A snapshot is never merged: it closes the window of its symbol
+// and goes out on its own.
+//
+// A wider window means fewer messages per client and more latency on the
+// first batch of each window.
+class batch_window {
+public:
+    explicit batch_window(const batch_window_config& config = {}) : config_(config) {}
+
+    bool enabled() const { return config_.window_us > 0; }
+
+    // publish(symbol, ticks) gets what is ready
+    template <typename F>
+    void add(symbol_id_t symbol, const batched_tick_update& ticks, int64_t now_ns, F&& publish) {
+        ++stats_.batches_in;
+        if (symbol >= pending_.size())
+            pending_.resize(symbol + 1);
+        pending_batch& p = pending_[symbol];
+        if (ticks.flag() == (uint64_t) updata_flag_t::snapshot) {
+            flush(symbol, publish);
+            ++stats_.batches_out;
+            publish(symbol, ticks);
+            return;
+        }
+        if (p.batches++ == 0) {
+            p.opened_ns = now_ns;
+            open_.emplace_back(symbol, now_ns);
+            p.ticks.CopyFrom(ticks);
+        } else {
+            append(p.ticks, ticks);
+        }
+        if ((size_t) p.ticks.updates_size() >= config_.max_updates)
+            flush(symbol, publish);
+    }
+
+    // publishes the windows that ended
+    template <typename F>
+    void poll(int64_t now_ns, F&& publish) {
+        int64_t window_ns = config_.window_us * 1000;
+        while (!open_.empty() && now_ns - open_.front().second >= window_ns) {
+            auto [symbol, opened_ns] = open_.front();
+            open_.pop_front();
+            // not if already published for its size, then maybe opened again
+            if (pending_[symbol].batches > 0 && pending_[symbol].opened_ns == opened_ns)
+                flush(symbol, publish);
+        }
+    }
+
+    const batch_window_stats& stats() const { return stats_; }
+
+private:
+    struct pending_batch {
+        batched_tick_update ticks;     // reused from one window to the next
+        size_t batches = 0;
+        int64_t opened_ns = 0;
+    };
+
+    static void append(batched_tick_update& into, const batched_tick_update& ticks) {
+        into.set_tick_id(ticks.tick_id());
+        if (into.exchange() == ticks.exchange()) {
+            into.mutable_updates()->MergeFrom(ticks.updates());
+            return;
+        }
+        if (into.exchange() != (uint32_t) exchange_t::undefined) {
+            for (auto& tick : *into.mutable_updates())
+                tick.set_exchange(into.exchange());
+            into.set_exchange((uint32_t) exchange_t::undefined);
+        }
+        for (const auto& tick : ticks.updates()) {
+            auto& merged = *into.add_updates();
+            merged = tick;
+            merged.set_exchange(ticks.exchange());
+        }
+    }
+
+    template <typename F>
+    void flush(symbol_id_t symbol, F& publish) {
+        pending_batch& p = pending_[symbol];
+        if (p.batches == 0)
+            return;
+        ++stats_.batches_out;
+        if (p.ticks.exchange() == (uint32_t) exchange_t::undefined)
+            ++stats_.merged;
+        publish(symbol, static_cast<const batched_tick_update&>(p.ticks));
+        p.ticks.Clear();
+        p.batches = 0;
+    }
+
+    batch_window_config config_;
+    std::vector<pending_batch> pending_;                    // by symbol id
+    std::deque<std::pair<symbol_id_t, int64_t>> open_;      // (symbol, opened at), oldest first
+    batch_window_stats stats_;
+};
+
+
+#endif  // _BATCH_WINDOW_H_
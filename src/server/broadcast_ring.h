@@ -0,0 +1,76 @@
+#ifndef _BROADCAST_RING_H_
+#define _BROADCAST_RING_H_
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+// Single producer, multiple consumer broadcast: every consumer sees every
+// item, in order. Slots are reused in place, so T keeps its allocations
+// from one lap to the next.
+//
+// No locks: the producer publishes a slot with a release store of its
+// sequence, each consumer releases the slots it is done with by storing its
+// own cursor. When the slowest consumer is a whole ring behind, the producer
+// waits for it instead of overwriting a slot still being read.
+template <typename T>
+class broadcast_ring {
+public:
+    broadcast_ring(size_t capacity, size_t consumers)
+        : mask_(round_up(capacity) - 1), slots_(mask_ + 1), cursors_(consumers) {}
+
+    // fill(T&) writes the next item in place
+    template <typename F>
+    void publish(F&& fill) {
+        uint64_t seq = head_.load(std::memory_order_relaxed);
+        while (seq - min_cursor() > mask_)
+            std::this_thread::yield();
+        fill(slots_[seq & mask_]);
+        head_.store(seq + 1, std::memory_order_release);
+    }
+
+    // calls f(const T&) on every item published since the last call of this
+    // consumer, returns how many
+    template <typename F>
+    size_t consume(size_t consumer, F&& f) {
+        std::atomic<uint64_t>& cursor = cursors_[consumer].seq;
+        uint64_t from = cursor.load(std::memory_order_relaxed);
+        uint64_t to = head_.load(std::memory_order_acquire);
+        for (uint64_t seq = from; seq < to; ++seq) {
+            f(static_cast<const T&>(slots_[seq & mask_]));
+            cursor.store(seq + 1, std::memory_order_release);
+        }
+        return to - from;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct alignas(64) consumer_cursor {
+        std::atomic<uint64_t> seq{0};
+    };
+
+    static size_t round_up(size_t n) {
+        size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    uint64_t min_cursor() const {
+        uint64_t min = head_.load(std::memory_order_relaxed);
+        for (const auto& c : cursors_)
+            min = std::min(min, c.seq.load(std::memory_order_acquire));
+        return min;
+    }
+
+    const uint64_t mask_;
+    std::vector<T> slots_;
+    std::vector<consumer_cursor> cursors_;
+    alignas(64) std::atomic<uint64_t> head_{0};
+};
+
+
+#endif  // _BROADCAST_RING_H_
@@ -0,0 +1,354 @@
+#ifndef _CALLBACK_SERVER_H_
+#define _CALLBACK_SERVER_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+#include "aggregator_server.h"
+
+
+// The batched stream, the snapshot and ListSymbols on gRPC's callback API:
+// no completion queue to drive, each stream is a ServerWriteReactor whose
+// write completions run on the gRPC callback threads. Same client_queue, slow
+// client policies, snapshot on subscription and depth views as the
+// completion queue server.
+// The analytics, the per-tick stream and the replay of tick_request.resume_from
+// are only served by aggregator_server: a stream resuming starts from a
+// snapshot here.
+using agg_callback_service = agg_service::WithCallbackMethod_TickSnapshotRequest<
+    agg_service::WithRawCallbackMethod_TickBatchedStreamRequest<
+    agg_service::WithCallbackMethod_ListSymbols<agg_service::Service>>>;
+
+class tick_stream_reactor;
+
+// Shared by the publisher and the callback threads. mutex guards everything
+// but the symbol registry; a reactor locks its own queue after it, never
+// before.
+struct callback_state {
+    callback_state(symbol_registry& symbols, client_queue_config queue_config)
+        : symbols(symbols), queue_config(queue_config) {}
+
+    symbol_registry& symbols;
+    client_queue_config queue_config;
+    std::mutex mutex;
+    consolidated_books books;
+    subscriber_index<tick_stream_reactor> clients;
+    depth_views<tick_stream_reactor> depth;
+    std::atomic<size_t> streams{0};
+};
+
+
+class tick_stream_reactor : public grpc::ServerWriteReactor<grpc::ByteBuffer>
+{
+public:
+    tick_stream_reactor(grpc::CallbackServerContext* ctx, const grpc::ByteBuffer* request_buffer, callback_state& state)
+        : ctx_(ctx), state_(state), mq_(state.queue_config)
+    {
+        tick_request request;
+        grpc::ByteBuffer copy(*request_buffer);
+        if (!grpc::SerializationTraits<tick_request>::Deserialize(&copy, &request).ok()) {
+            finish(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "malformed tick_request"));
+            return;
+        }
+        if (grpc::Status status = parse_subscription(request, state_.symbols, subscription_); !status.ok()) {
+            finish(status);
+            return;
+        }
+        if (subscription_.depth > 0 && subscription_.symbols.empty()) {
+            finish(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "depth needs a symbol"));
+            return;
+        }
+        LOG(INFO) << "client connected";
+        mq_.set_conflate_levels(request.conflate());
+        mq_.set_coalesce(request.coalesce());
+        mq_.set_encoding(stream_encoding(request));
+
+        // the snapshot is queued under the state lock: no batch can come in between
+        std::lock_guard<std::mutex> lock(state_.mutex);
+        state_.clients.add(this, subscription_);
+        if (subscription_.depth > 0)
+            for (symbol_id_t symbol : subscription_.symbols)
+                depth_views_.push_back(&state_.depth.add(this, symbol, subscription_.depth, state_.books.find(symbol)));
+        subscribed_ = true;
+        state_.streams.fetch_add(1, std::memory_order_relaxed);
+        send_snapshot();
+    }
+
+    // state.mutex held: payload is ticks serialized, shared with the other clients
+    void send_update(const batched_tick_update& ticks, const grpc::ByteBuffer& payload) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (disconnecting_ || finished_)
+            return;
+        if (!mq_.push(ticks, payload)) {
+            LOG(WARNING) << "client " << ctx_->peer() << " too slow, disconnecting";
+            unsubscribe();
+            mq_.clear();
+            if (mq_.writing())
+                disconnecting_ = true;
+            else
+                finish(grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED, "client too slow"));
+            return;
+        }
+        try_write();
+    }
+
+    void OnWriteDone(bool ok) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!ok) {
+            // the client is gone
+            LOG(INFO) << "client disconnected";
+            finish(grpc::Status::CANCELLED);
+            return;
+        }
+        mq_.end_write();
+        if (disconnecting_)
+            finish(grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED, "client too slow"));
+        else
+            try_write();
+    }
+
+    // a write in flight fails and finishes the stream, otherwise it is done here
+    void OnCancel() override {
+        std::lock_guard<std::mutex> state_lock(state_.mutex);
+        unsubscribe();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!mq_.writing())
+            finish(grpc::Status::CANCELLED);
+    }
+
+    void OnDone() override {
+        {
+            std::lock_guard<std::mutex> lock(state_.mutex);
+            unsubscribe();
+        }
+        delete this;
+    }
+
+    size_t queue_depth() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return mq_.size();
+    }
+
+    // set once before the reactor is subscribed
+    wire_encoding encoding() const {
+        return mq_.encoding();
+    }
+
+    client_queue_stats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return mq_.stats();
+    }
+
+    std::string peer() const {
+        return ctx_->peer();
+    }
+
+private:
+    // state.mutex held
+    void send_snapshot() {
+        std::vector<batched_tick_update> batches;
+        if (subscription_.depth > 0) {
+            for (const depth_view* view : depth_views_) {
+                if (view->empty())
+                    continue;
+                batches.emplace_back();
+                view->snapshot(batches.back());
+            }
+        } else if (subscription_.symbols.empty()) {
+            state_.books.snapshot_all(batches);
+        } else {
+            for (symbol_id_t symbol : subscription_.symbols)
+                state_.books.snapshot(symbol, batches);
+        }
+
+        for (const auto& ticks : batches) {
+            if (subscription_.depth == 0 && !subscription_.wants(ticks.exchange()))
+                continue;
+            grpc::ByteBuffer payload;
+            serialize_batch(ticks, mq_.encoding(), payload);
+            send_update(ticks, payload);
+        }
+    }
+
+    // state.mutex held
+    void unsubscribe() {
+        if (!subscribed_)
+            return;
+        subscribed_ = false;
+        state_.clients.remove(this, subscription_);
+        for (const depth_view* view : depth_views_)
+            state_.depth.remove(this, view->symbol(), view->depth());
+        depth_views_.clear();
+        state_.streams.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // mutex_ held from here on
+    void finish(const grpc::Status& status) {
+        if (finished_)
+            return;
+        finished_ = true;
+        Finish(status);
+    }
+
+    void try_write() {
+        if (!mq_.writing() && !mq_.empty())
+            StartWrite(&mq_.begin_write());
+    }
+
+    grpc::CallbackServerContext* ctx_;
+    callback_state& state_;
+    subscription subscription_;
+    std::vector<const depth_view*> depth_views_;
+    bool subscribed_ = false;       // guarded by state.mutex
+
+    mutable std::mutex mutex_;
+    client_queue mq_;
+    bool disconnecting_ = false;
+    bool finished_ = false;
+};
+
+
+// Same interface as a single queue aggregator_server, without the polling:
+// process_tick can be called from the link thread while gRPC runs the
+// streams on its own threads.
+class callback_server
+{
+public:
+    callback_server(uint16_t port, symbol_registry& symbols, client_queue_config queue_config = {})
+        : state_(symbols, queue_config), service_(state_)
+    {
+        std::string server_address = absl::StrFormat("0.0.0.0:%d", port);
+
+        grpc::EnableDefaultHealthCheckService(true);
+        grpc::reflection::InitProtoReflectionServerBuilderPlugin();
+
+        grpc::ServerBuilder builder;
+        builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
+        builder.RegisterService(&service_);
+        server_ = builder.BuildAndStart();
+        std::cout << "Server listening on " << server_address << " (callback API)" << std::endl;
+    }
+
+    ~callback_server()
+    {
+        // cancels the streams and waits for their OnDone
+        server_->Shutdown(std::chrono::system_clock::now());
+    }
+
+    void process_tick(symbol_id_t symbol_id, const batched_tick_update& ticks) {
+        std::lock_guard<std::mutex> lock(state_.mutex);
+        state_.books.update(symbol_id, ticks);
+        const auto& book = *state_.books.find(symbol_id);
+        state_.depth.publish(symbol_id, book, ticks.tick_id(),
+            [] (tick_stream_reactor* client, const batched_tick_update& changes, const grpc::ByteBuffer& payload) {
+                client->send_update(changes, payload);
+            });
+
+        size_t bytes = 0;
+        size_t subscribers = publish_batch(state_.clients, symbol_id, ticks, book.scale, bytes,
+            [] (tick_stream_reactor* client, const batched_tick_update& batch, const grpc::ByteBuffer& payload) {
+                client->send_update(batch, payload);
+            });
+        if (subscribers == 0)
+            return;
+
+        if (binlog::enabled())
+            BINLOG("To client: symbol {} exchange {} tick_id {} updates {} clients {} bytes {}",
+                symbol_id, ticks.exchange(), ticks.tick_id(), ticks.updates_size(), subscribers, bytes);
+        else
+            LOG_RATE_LIMITED(INFO, hot_path_log_rate) << "To client:" << ticks.ShortDebugString();
+    }
+
+    // tick streams connected, from any thread
+    size_t streams() const {
+        return state_.streams.load(std::memory_order_relaxed);
+    }
+
+    // batches queued over every stream
+    size_t queued() {
+        std::lock_guard<std::mutex> lock(state_.mutex);
+        size_t n = 0;
+        for (auto* client : state_.clients.all())
+            n += client->queue_depth();
+        return n;
+    }
+
+    void log_client_stats() {
+        std::lock_guard<std::mutex> lock(state_.mutex);
+        for (auto* client : state_.clients.all()) {
+            client_queue_stats s = client->stats();
+            LOG(INFO) << "client " << client->peer() << ": depth " << s.depth << " max depth " << s.max_depth
+                      << " queued " << s.queued << " written " << s.written
+                      << " dropped " << s.dropped << " conflated " << s.conflated
+                      << " writes " << s.writes << " batches per write " << s.write_size_distribution();
+        }
+        if (uint64_t dropped = binlog::stats::dropped.load(std::memory_order_relaxed))
+            LOG(WARNING) << "binary log: dropped " << dropped << " events";
+    }
+
+    std::function<void(symbol_id_t, const batched_tick_update&)> get_process_ticks() {
+        return [this] (symbol_id_t symbol_id, const batched_tick_update& ticks) {
+            return this->process_tick(symbol_id, ticks);
+        };
+    }
+
+private:
+    class service : public agg_callback_service {
+    public:
+        explicit service(callback_state& state) : state_(state) {}
+
+        grpc::ServerWriteReactor<grpc::ByteBuffer>* TickBatchedStreamRequest(
+            grpc::CallbackServerContext* ctx, const grpc::ByteBuffer* request) override {
+            return new tick_stream_reactor(ctx, request, state_);
+        }
+
+        grpc::ServerUnaryReactor* TickSnapshotRequest(
+            grpc::CallbackServerContext* ctx, const tick_request* request, tick_snapshot* reply) override {
+            auto* reactor = ctx->DefaultReactor();
+            std::vector<batched_tick_update> batches;
+            {
+                std::lock_guard<std::mutex> lock(state_.mutex);
+                if (request->symbol().empty()) {
+                    state_.books.snapshot_all(batches);
+                } else {
+                    symbol_id_t symbol = state_.symbols.find(request->symbol());
+                    if (!state_.books.find(symbol)) {
+                        reactor->Finish(grpc::Status(grpc::StatusCode::NOT_FOUND, "unknown symbol " + request->symbol()));
+                        return reactor;
+                    }
+                    state_.books.snapshot(symbol, batches);
+                }
+            }
+            for (auto& ticks : batches)
+                *reply->add_books() = std::move(ticks);
+            reactor->Finish(grpc::Status::OK);
+            return reactor;
+        }
+
+        grpc::ServerUnaryReactor* ListSymbols(
+            grpc::CallbackServerContext* ctx, const symbol_list_request* request, symbol_list* reply) override {
+            auto* reactor = ctx->DefaultReactor();
+            {
+                std::lock_guard<std::mutex> lock(state_.mutex);
+                list_symbols(*request, state_.symbols, state_.books, *reply);
+            }
+            reactor->Finish(grpc::Status::OK);
+            return reactor;
+        }
+
+    private:
+        callback_state& state_;
+    };
+
+    callback_state state_;
+    service service_;
+    std::unique_ptr<grpc::Server> server_;
+};
+
+
+#endif  // _CALLBACK_SERVER_H_
@@ -0,0 +1,469 @@
+#ifndef _CLIENT_QUEUE_H_
+#define _CLIENT_QUEUE_H_
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+#include "../common.h"
+#include "../protos/aggregator.grpc.pb.h"
+#include "../wire_codec.h"
+
+using agg_proto::batched_tick_update;
+using agg_proto::tick_update;
+using agg_proto::wire_encoding;
+
+
+// What to do when a client falls more than max_depth batches behind.
+enum class slow_client_policy {
+    drop_oldest,    // drop the oldest queued batch, the client book is left inconsistent
+    conflate,       // merge the batch into the last queued batch of the same symbol and exchange
+    disconnect      // finish the stream with RESOURCE_EXHAUSTED
+};
+
+inline bool parse_slow_client_policy(const std::string& name, slow_client_policy& policy) {
+    if (name == "drop_oldest") policy = slow_client_policy::drop_oldest;
+    else if (name == "conflate") policy = slow_client_policy::conflate;
+    else if (name == "disconnect") policy = slow_client_policy::disconnect;
+    else return false;
+    return true;
+}
+
+// ticks as written to a stream asking for encoding, scale is that of its
+// symbol for the compact levels
+inline void serialize_batch(const batched_tick_update& ticks, wire_encoding encoding, const wire_codec::scale& scale,
+    grpc::ByteBuffer& payload) {
+    bool own_buffer;
+    if (encoding == agg_proto::encoding_updates || ticks.updates_size() == 0) {
+        grpc::SerializationTraits<batched_tick_update>::Serialize(ticks, &payload, &own_buffer);
+        return;
+    }
+    batched_tick_update encoded;
+    // a level out of the range of the scale: as updates, which every client reads
+    if (!wire_codec::encode(ticks, scale, encoded, encoding == agg_proto::encoding_delta)) {
+        grpc::SerializationTraits<batched_tick_update>::Serialize(ticks, &payload, &own_buffer);
+        return;
+    }
+    grpc::SerializationTraits<batched_tick_update>::Serialize(encoded, &payload, &own_buffer);
+}
+
+// with the scale fitted to ticks alone, for the batches not published as such
+inline void serialize_batch(const batched_tick_update& ticks, wire_encoding encoding, grpc::ByteBuffer& payload) {
+    wire_codec::scale scale;
+    if (encoding != agg_proto::encoding_updates)
+        wire_codec::fit(ticks, scale);
+    serialize_batch(ticks, encoding, scale, payload);
+}
+
+struct client_queue_config {
+    size_t max_depth = 1024;
+    slow_client_policy policy = slow_client_policy::conflate;
+    size_t max_coalesced_bytes = 1 << 20;   // per coalesced write, under the 4 MB default client limit
+};
+
+struct client_queue_stats {
+    size_t depth = 0;
+    size_t max_depth = 0;       // high water mark
+    uint64_t queued = 0;
+    uint64_t written = 0;
+    uint64_t dropped = 0;
+    uint64_t conflated = 0;
+    uint64_t writes = 0;
+    // batches per write: 1, 2, 3-4, 5-8, ... 65 and more
+    std::array<uint64_t, 8> write_sizes{};
+
+    static size_t write_size_bucket(size_t batches) {
+        size_t bucket = 0;
+        for (size_t n = batches - 1; n > 0 && bucket + 1 < std::tuple_size<decltype(write_sizes)>::value; n >>= 1)
+            ++bucket;
+        return bucket;
+    }
+
+    // "1:n 2:n 3-4:n ..." without the empty buckets
+    std::string write_size_distribution() const {
+        std::string out;
+        for (size_t i = 0; i < write_sizes.size(); ++i) {
+            if (write_sizes[i] == 0)
+                continue;
+            size_t low = i == 0 ? 1 : (1u << (i - 1)) + 1, high = 1u << i;
+            if (!out.empty())
+                out += ' ';
+            out += std::to_string(low);
+            if (i + 1 == write_sizes.size())
+                out += '+';
+            else if (high > low)
+                out += '-' + std::to_string(high);
+            out += ':' + std::to_string(write_sizes[i]);
+        }
+        return out;
+    }
+};
+
+
+// Outgoing batches of one client, bounded by client_queue_config.
+// The front entry is the one being written and is never touched by the
+// overflow policy.
+//
+// A client subscribed with tick_request.conflate gets level conflation
+// instead: while a write is in flight the updates are merged per
+// (symbol, exchange, side, fixed price), and the next write carries one
+// batch per symbol and exchange with the latest quantity of each changed
+// level.
+//
+// A client subscribed with tick_request.coalesce gets every queued batch in
+// one write: a batched_tick_update whose repeated batches field is made of
+// the payloads already serialized, framed without copying them.
+//
+// Each batch queued takes the next sequence number of the stream, written
+// after its payload as the batched_tick_update.sequence field: the payloads
+// stay shared with the other clients. A batch dropped leaves its number
+// missing, one conflated into a queued batch takes none. So is the
+// publish_sequence pushed with the batch, if any, which never goes back: a
+// batch conflated into one queued before others leaves it the publish_sequence
+// it had, and of the batches of a level conflation only the last carries one.
+// A client resuming from there is sent again changes it has, which it applies
+// again to the same result. The publish_epoch of the server goes with it.
+//
+// The payloads pushed are in the encoding of the client (set_encoding), so
+// are the batches the queue merges itself.
+class client_queue {
+public:
+    explicit client_queue(const client_queue_config& config) : config_(config) {}
+
+    void set_conflate_levels(bool conflate) {
+        conflate_levels_ = conflate;
+    }
+
+    void set_coalesce(bool coalesce) {
+        coalesce_ = coalesce;
+    }
+
+    void set_encoding(wire_encoding encoding) {
+        encoding_ = encoding;
+    }
+
+    wire_encoding encoding() const { return encoding_; }
+
+    // the publish_epoch written with each publish_sequence
+    void set_epoch(uint64_t epoch) {
+        epoch_ = epoch;
+    }
+
+    // false when the client has to be disconnected
+    bool push(const batched_tick_update& ticks, const grpc::ByteBuffer& payload, uint64_t published = 0) {
+        ++stats_.queued;
+        if (conflate_levels_ && !entries_.empty()) {
+            merge_levels(ticks, published);
+            return true;
+        }
+        if (entries_.size() >= config_.max_depth + in_flight_) {
+            switch (config_.policy) {
+            case slow_client_policy::disconnect:
+                return false;
+            case slow_client_policy::drop_oldest:
+                entries_.erase(entries_.begin() + in_flight_);
+                ++stats_.dropped;
+                break;
+            case slow_client_policy::conflate:
+                if (conflate(ticks, published))
+                    return true;
+                // nothing of this symbol and exchange left to merge into, queue it
+                // anyway: the depth can exceed the bound by at most the number of
+                // books the client subscribed to
+                break;
+            }
+        }
+        entries_.push_back({payload, ticks.symbol_id(), ticks.exchange(), nullptr, ++sequence_, published});
+        update_depth();
+        return true;
+    }
+
+    bool empty() const { return entries_.empty(); }
+    size_t size() const { return entries_.size(); }
+    bool writing() const { return in_flight_ > 0; }
+
+    // payload of the front entries, which stay queued until end_write()
+    const grpc::ByteBuffer& begin_write() {
+        serialize(entries_.front());
+        in_flight_ = 1;
+        std::vector<grpc::Slice> slices;
+        if (!coalesce_ || entries_.size() == 1) {
+            append_payload(entries_.front(), slices);
+            written_ = grpc::ByteBuffer(slices.data(), slices.size());
+            return written_;
+        }
+
+        size_t bytes = batch_size(entries_.front());
+        while (in_flight_ < entries_.size()) {
+            entry& e = entries_[in_flight_];
+            serialize(e);
+            size_t size = batch_size(e);
+            if (bytes + size > config_.max_coalesced_bytes)
+                break;
+            bytes += size;
+            ++in_flight_;
+        }
+        if (in_flight_ == 1)
+            append_payload(entries_.front(), slices);
+        else
+            for (size_t i = 0; i < in_flight_; ++i)
+                append_batch(entries_[i], slices);
+        written_ = grpc::ByteBuffer(slices.data(), slices.size());
+        return written_;
+    }
+
+    void end_write() {
+        entries_.erase(entries_.begin(), entries_.begin() + in_flight_);
+        stats_.written += in_flight_;
+        ++stats_.writes;
+        ++stats_.write_sizes[client_queue_stats::write_size_bucket(in_flight_)];
+        in_flight_ = 0;
+        written_.Clear();
+        if (entries_.empty())
+            flush_levels();
+        update_depth();
+    }
+
+    void clear() {
+        entries_.erase(entries_.begin() + in_flight_, entries_.end());
+        pending_.clear();
+        pending_published_ = 0;
+        update_depth();
+    }
+
+    const client_queue_stats& stats() const { return stats_; }
+
+    // of the last batch queued
+    uint64_t sequence() const { return sequence_; }
+
+private:
+    // (exchange of the update in a batch merged across exchanges, side, fixed price)
+    using level_key = std::tuple<uint32_t, uint32_t, int64_t>;
+
+    static level_key key_of(const tick_update& tick) {
+        return {tick.exchange(), tick.side(), static_cast<int64_t>(tick.price() * fixed_price_scale)};
+    }
+
+    // a queued batch being conflated, with the update of each of its levels
+    struct merged_batch {
+        batched_tick_update ticks;
+        std::map<level_key, int> levels;    // index in ticks.updates
+
+        // keeps the last update of each level, where its first one was
+        void index() {
+            levels.clear();
+            auto& updates = *ticks.mutable_updates();
+            int n = 0;
+            for (int i = 0; i < updates.size(); ++i) {
+                auto [level, added] = levels.emplace(key_of(updates[i]), n);
+                if (added && i != n)
+                    updates.SwapElements(i, n);
+                else if (!added)
+                    updates.Mutable(level->second)->Swap(updates.Mutable(i));
+                n += added;
+            }
+            updates.DeleteSubrange(n, updates.size() - n);
+        }
+    };
+
+    struct entry {
+        grpc::ByteBuffer payload;
+        uint32_t symbol_id;
+        uint32_t exchange;
+        std::unique_ptr<merged_batch> merged;   // set once conflated, serialized on write
+        uint64_t sequence;
+        uint64_t published;
+    };
+
+    void serialize(entry& e) {
+        if (!e.merged)
+            return;
+        serialize_batch(e.merged->ticks, encoding_, e.payload);
+        e.merged.reset();
+    }
+
+    static size_t put_varint(uint64_t value, uint8_t* out) {
+        size_t n = 0;
+        for (; ; value >>= 7) {
+            out[n++] = (value & 0x7f) | (value >= 0x80 ? 0x80 : 0);
+            if (value < 0x80)
+                return n;
+        }
+    }
+
+    static size_t varint_size(uint64_t value) {
+        size_t n = 1;
+        for (; value >= 0x80; value >>= 7)
+            ++n;
+        return n;
+    }
+
+    // of e as written by append_batch
+    size_t batch_size(const entry& e) const {
+        size_t length = e.payload.Length() + 1 + varint_size(e.sequence);
+        if (e.published)
+            length += 1 + varint_size(e.published) + (epoch_ ? 1 + varint_size(epoch_) : 0);
+        return 1 + varint_size(length) + length;
+    }
+
+    // the payload slices of e, then its sequence fields: a message followed
+    // by a field parses as the message with that field set
+    size_t append_payload(const entry& e, std::vector<grpc::Slice>& slices) const {
+        constexpr uint8_t sequence_tag = 9 << 3;            // field 9, varint
+        constexpr uint8_t publish_sequence_tag = 10 << 3;   // field 10, varint
+        constexpr uint8_t publish_epoch_tag = 11 << 3;      // field 11, varint
+        std::vector<grpc::Slice> own;
+        e.payload.Dump(&own);
+        slices.insert(slices.end(), own.begin(), own.end());
+        uint8_t fields[3 * (1 + 10)];
+        size_t n = 0;
+        fields[n++] = sequence_tag;
+        n += put_varint(e.sequence, fields + n);
+        if (e.published) {
+            fields[n++] = publish_sequence_tag;
+            n += put_varint(e.published, fields + n);
+            if (epoch_) {
+                fields[n++] = publish_epoch_tag;
+                n += put_varint(epoch_, fields + n);
+            }
+        }
+        slices.emplace_back(fields, n);
+        return e.payload.Length() + n;
+    }
+
+    // e as one element of batched_tick_update.batches: its tag and length,
+    // then its slices
+    void append_batch(const entry& e, std::vector<grpc::Slice>& slices) const {
+        constexpr uint8_t batches_tag = (6 << 3) | 2;   // field 6, length delimited
+        uint8_t header[1 + 10];
+        header[0] = batches_tag;
+        size_t at = slices.size();
+        slices.emplace_back();      // the header, once the length is known
+        size_t length = append_payload(e, slices);
+        size_t n = 1 + put_varint(length, header + 1);
+        slices[at] = grpc::Slice(header, n);
+    }
+
+    // Books of different symbols and exchanges are independent, so a batch
+    // can be merged into the last queued batch of its symbol and exchange even
+    // if batches of other books were queued in between. An update replaces the
+    // one queued at its level, so the merged batch never holds more than a book.
+    bool conflate(const batched_tick_update& ticks, uint64_t published) {
+        for (size_t i = entries_.size(); i-- > (size_t) in_flight_;) {
+            entry& e = entries_[i];
+            if (e.symbol_id != ticks.symbol_id() || e.exchange != ticks.exchange())
+                continue;
+
+            if (!e.merged) {
+                e.merged = std::make_unique<merged_batch>();
+                batched_tick_update& merged = e.merged->ticks;
+                grpc::SerializationTraits<batched_tick_update>::Deserialize(&e.payload, &merged);
+                if (merged.has_levels()) {
+                    batched_tick_update decoded;
+                    wire_codec::decode(merged, decoded);
+                    merged.Swap(&decoded);
+                }
+                e.merged->index();
+            }
+            batched_tick_update& merged = e.merged->ticks;
+            if (ticks.flag() == (uint64_t) updata_flag_t::snapshot) {
+                // a snapshot replaces everything queued before it
+                merged.CopyFrom(ticks);
+                e.merged->index();
+            } else {
+                merged.set_tick_id(ticks.tick_id());
+                for (const auto& tick : ticks.updates()) {
+                    auto [level, added] = e.merged->levels.emplace(key_of(tick), merged.updates_size());
+                    if (added)
+                        *merged.add_updates() = tick;
+                    else
+                        *merged.mutable_updates(level->second) = tick;
+                }
+            }
+            if (i + 1 == entries_.size())
+                e.published = published;
+            ++stats_.conflated;
+            return true;
+        }
+        return false;
+    }
+
+    struct pending_levels {
+        int64_t tick_id = 0;
+        bool snapshot = false;
+        std::map<std::pair<uint32_t, int64_t>, tick_update> levels;     // (side, fixed price)
+    };
+
+    void merge_levels(const batched_tick_update& ticks, uint64_t published) {
+        if (ticks.flag() == (uint64_t) updata_flag_t::snapshot) {
+            // the client clears this book anyway, earlier changes are moot
+            pending_levels& pending = pending_[{ticks.symbol_id(), ticks.exchange()}];
+            pending.levels.clear();
+            pending.snapshot = true;
+        }
+        for (const auto& tick : ticks.updates()) {
+            // the updates of a batch merged across exchanges carry their own
+            uint32_t exchange = tick.exchange() ? tick.exchange() : ticks.exchange();
+            pending_levels& pending = pending_[{ticks.symbol_id(), exchange}];
+            pending.tick_id = ticks.tick_id();
+            int64_t price = static_cast<int64_t>(tick.price() * fixed_price_scale);
+            tick_update& level = pending.levels[{tick.side(), price}];
+            level = tick;
+            level.clear_exchange();
+        }
+        pending_published_ = std::max(pending_published_, published);
+        ++stats_.conflated;
+    }
+
+    // net changes since the last write, one batch per symbol and exchange,
+    // the last with the publish_sequence of the last batch merged
+    void flush_levels() {
+        size_t left = pending_.size();
+        for (auto& [book, pending] : pending_) {
+            auto [symbol_id, exchange] = book;
+            batched_tick_update ticks;
+            ticks.set_symbol_id(symbol_id);
+            ticks.set_exchange(exchange);
+            ticks.set_tick_id(pending.tick_id);
+            if (pending.snapshot)
+                ticks.set_flag((uint64_t) updata_flag_t::snapshot);
+            for (const auto& level : pending.levels)
+                *ticks.add_updates() = level.second;
+
+            entry e{{}, symbol_id, exchange, nullptr, ++sequence_, --left == 0 ? pending_published_ : 0};
+            serialize_batch(ticks, encoding_, e.payload);
+            entries_.push_back(std::move(e));
+        }
+        pending_.clear();
+        pending_published_ = 0;
+    }
+
+    void update_depth() {
+        stats_.depth = entries_.size();
+        stats_.max_depth = std::max(stats_.max_depth, stats_.depth);
+    }
+
+    const client_queue_config& config_;
+    std::deque<entry> entries_;
+    size_t in_flight_ = 0;          // front entries being written
+    grpc::ByteBuffer written_;      // their payloads, with the sequence of each
+    uint64_t sequence_ = 0;
+    bool conflate_levels_ = false;
+    bool coalesce_ = false;
+    wire_encoding encoding_ = agg_proto::encoding_updates;
+    uint64_t epoch_ = 0;
+    std::map<std::pair<uint32_t, uint32_t>, pending_levels> pending_;   // by (symbol_id, exchange)
+    uint64_t pending_published_ = 0;
+    client_queue_stats stats_;
+};
+
+
+#endif  // _CLIENT_QUEUE_H_
@@ -0,0 +1,82 @@
+#ifndef _CONSOLIDATED_BOOKS_H_
+#define _CONSOLIDATED_BOOKS_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../client/orderbook.h"
+#include "../symbol_registry.h"
+#include "../wire_codec.h"
+
+
+// The server side copy of every symbol book, fed with the same batches as
+// the clients. New subscribers start from a snapshot of it.
+class consolidated_books {
+public:
+    struct symbol_book {
+        symbol_id_t symbol_id = 0;
+        order_book::extended_book book;
+        bool received[(uint32_t) exchange_t::total] = {};
+        int64_t tick_id[(uint32_t) exchange_t::total] = {};     // last batch applied, per exchange
+        wire_codec::scale scale;    // of the compact streams, fits every batch applied
+    };
+
+    void update(symbol_id_t symbol_id, const batched_tick_update& ticks) {
+        if (symbol_id >= books_.size())
+            books_.resize(symbol_id + 1);
+        auto& book = books_[symbol_id];
+        if (!book) {
+            book = std::make_unique<symbol_book>();
+            book->symbol_id = symbol_id;
+        }
+        book->book.update_ticks(ticks);
+        wire_codec::fit(ticks, book->scale);
+        auto received = [&] (uint32_t exchange) {
+            if (exchange < (uint32_t) exchange_t::total) {
+                book->received[exchange] = true;
+                book->tick_id[exchange] = ticks.tick_id();
+            }
+        };
+        if (ticks.exchange() != (uint32_t) exchange_t::undefined) {
+            received(ticks.exchange());
+            return;
+        }
+        // a batch merged across exchanges
+        for (const auto& tick : ticks.updates())
+            received(tick.exchange());
+    }
+
+    const symbol_book* find(symbol_id_t symbol_id) const {
+        return symbol_id < books_.size() ? books_[symbol_id].get() : nullptr;
+    }
+
+    // appends one batch flagged snapshot per exchange quoting the symbol
+    void snapshot(symbol_id_t symbol_id, std::vector<batched_tick_update>& batches) const {
+        if (const symbol_book* book = find(symbol_id))
+            append_snapshot(*book, batches);
+    }
+
+    void snapshot_all(std::vector<batched_tick_update>& batches) const {
+        for (const auto& book : books_)
+            if (book) append_snapshot(*book, batches);
+    }
+
+private:
+    static void append_snapshot(const symbol_book& book, std::vector<batched_tick_update>& batches) {
+        for (uint32_t exchange = 1; exchange < (uint32_t) exchange_t::total; ++exchange) {
+            if (!book.received[exchange])
+                continue;
+            batched_tick_update ticks;
+            ticks.set_symbol_id(book.symbol_id);
+            ticks.set_tick_id(book.tick_id[exchange]);
+            book.book.snapshot(exchange, ticks);
+            batches.push_back(std::move(ticks));
+        }
+    }
+
+    std::vector<std::unique_ptr<symbol_book>> books_;   // by symbol id
+};
+
+
+#endif  // _CONSOLIDATED_BOOKS_H_
@@ -0,0 +1,187 @@
+#ifndef _DEPTH_VIEWS_H_
+#define _DEPTH_VIEWS_H_
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+#include "../common.h"
+#include "../symbol_registry.h"
+#include "consolidated_books.h"
+
+
+// The consolidated top N levels per side of one symbol, as last sent to the
+// depth streams. Each update is diffed against it: only the levels that
+// changed are sent, and a level pushed out of the top N is sent with
+// quantity 0.
+class depth_view {
+public:
+    depth_view(symbol_id_t symbol, uint32_t depth) : symbol_(symbol), depth_(depth) {}
+
+    symbol_id_t symbol() const { return symbol_; }
+    uint32_t depth() const { return depth_; }
+
+    // the changes since the last call, false if the top N did not change
+    bool update(const consolidated_books::symbol_book& book, int64_t tick_id, batched_tick_update& changes) {
+        tick_id_ = tick_id;
+        changes.Clear();
+        diff(book.book, side_t::bid, bids_, changes);
+        diff(book.book, side_t::ask, asks_, changes);
+        if (changes.updates_size() == 0)
+            return false;
+        changes.set_symbol_id(symbol_);
+        changes.set_exchange((uint32_t) exchange_t::undefined);
+        changes.set_tick_id(tick_id_);
+        return true;
+    }
+
+    // the top N as last sent, flagged snapshot
+    void snapshot(batched_tick_update& ticks) const {
+        ticks.set_symbol_id(symbol_);
+        ticks.set_exchange((uint32_t) exchange_t::undefined);
+        ticks.set_tick_id(tick_id_);
+        ticks.set_flag((uint64_t) updata_flag_t::snapshot);
+        for (const auto& [key, level] : bids_)
+            append(side_t::bid, level, ticks);
+        for (const auto& [key, level] : asks_)
+            append(side_t::ask, level, ticks);
+    }
+
+    bool empty() const {
+        return bids_.empty() && asks_.empty();
+    }
+
+private:
+    using levels = std::map<int64_t, order_book::tick_data>;     // by fixed price
+
+    static bool same_level(const order_book::tick_data& a, const order_book::tick_data& b) {
+        return std::equal(std::begin(a.qty), std::end(a.qty), std::begin(b.qty));
+    }
+
+    static void append(side_t side, const order_book::tick_data& level, batched_tick_update& ticks) {
+        auto& tick = *ticks.add_updates();
+        tick.set_side((uint32_t) side);
+        tick.set_price(level.price);
+        tick.set_quantity(level.qty[0]);
+        tick.set_tick_id(ticks.tick_id());
+        for (uint32_t exchange = 1; exchange < (uint32_t) exchange_t::total; ++exchange)
+            tick.add_venue_quantity(level.qty[exchange]);
+    }
+
+    void diff(const order_book::extended_book& book, side_t side, levels& sent, batched_tick_update& changes) {
+        changes.set_tick_id(tick_id_);
+        levels top;
+        book.for_each_top(side, depth_, [&] (int64_t key, const order_book::tick_data& level) {
+            top.emplace(key, level);
+        });
+        for (const auto& [key, level] : top) {
+            auto it = sent.find(key);
+            if (it == sent.end() || !same_level(it->second, level))
+                append(side, level, changes);
+        }
+        for (const auto& [key, level] : sent) {
+            if (top.count(key) == 0) {
+                order_book::tick_data gone = {};
+                gone.price = level.price;
+                append(side, gone, changes);
+            }
+        }
+        sent.swap(top);
+    }
+
+    symbol_id_t symbol_;
+    uint32_t depth_;
+    int64_t tick_id_ = 0;
+    levels bids_;
+    levels asks_;
+};
+
+
+// The depth views with at least one subscriber, one per (symbol, depth):
+// streams asking for the same depth of the same symbol share the diff and
+// its serialization, so the cost of an update is one diff per distinct
+// view, not one per client.
+template <typename Client>
+class depth_views {
+public:
+    // the view the client now receives, to take its snapshot from
+    const depth_view& add(Client* client, symbol_id_t symbol, uint32_t depth, const consolidated_books::symbol_book* book) {
+        entry& e = find_or_add(symbol, depth);
+        if (e.subscribers.empty() && book) {
+            // not updated while nobody listened, catch up silently
+            batched_tick_update discard;
+            e.view->update(*book, e.tick_id, discard);
+        }
+        e.subscribers.push_back(client);
+        return *e.view;
+    }
+
+    void remove(Client* client, symbol_id_t symbol, uint32_t depth) {
+        if (symbol >= symbols_.size())
+            return;
+        for (entry& e : symbols_[symbol]) {
+            if (e.view->depth() != depth)
+                continue;
+            auto it = std::find(e.subscribers.begin(), e.subscribers.end(), client);
+            if (it != e.subscribers.end())
+                e.subscribers.erase(it);
+        }
+    }
+
+    // Calls send(client, changes, payload) for every subscriber of a view of
+    // the symbol whose top N changed. Backwards, so send may remove the
+    // client it is called on; views are kept when their last subscriber
+    // leaves for the same reason.
+    template <typename F>
+    void publish(symbol_id_t symbol, const consolidated_books::symbol_book& book, int64_t tick_id, F&& send) {
+        if (symbol >= symbols_.size())
+            return;
+        for (entry& e : symbols_[symbol]) {
+            e.tick_id = tick_id;
+            if (e.subscribers.empty() || !e.view->update(book, tick_id, changes_))
+                continue;
+            grpc::ByteBuffer payload;
+            bool own_buffer;
+            grpc::SerializationTraits<batched_tick_update>::Serialize(changes_, &payload, &own_buffer);
+            for (size_t i = e.subscribers.size(); i-- > 0;)
+                send(e.subscribers[i], changes_, payload);
+        }
+    }
+
+    // number of views with at least one subscriber
+    size_t size() const {
+        size_t n = 0;
+        for (const auto& views : symbols_)
+            for (const auto& e : views)
+                n += !e.subscribers.empty();
+        return n;
+    }
+
+private:
+    struct entry {
+        std::unique_ptr<depth_view> view;
+        std::vector<Client*> subscribers;
+        int64_t tick_id = 0;    // last batch of the symbol
+    };
+
+    entry& find_or_add(symbol_id_t symbol, uint32_t depth) {
+        if (symbol >= symbols_.size())
+            symbols_.resize(symbol + 1);
+        auto& views = symbols_[symbol];
+        for (entry& e : views)
+            if (e.view->depth() == depth)
+                return e;
+        views.push_back({std::make_unique<depth_view>(symbol, depth), {}, 0});
+        return views.back();
+    }
+
+    std::vector<std::vector<entry>> symbols_;   // by symbol id
+    batched_tick_update changes_;
+};
+
+
+#endif  // _DEPTH_VIEWS_H_
@@ -0,0 +1,97 @@
+#ifndef _REPLAY_RING_H_
+#define _REPLAY_RING_H_
+
+#include <stdint.h>
+#include <algorithm>
+#include <deque>
+
+#include "../common.h"
+#include "../protos/aggregator.grpc.pb.h"
+#include "../symbol_registry.h"
+
+using agg_proto::batched_tick_update;
+
+
+struct replay_config {
+    size_t max_bytes = 0;       // of the batches kept, 0: no bound on the size
+    int64_t max_age_ms = 0;     // 0: no bound on the age
+};
+
+struct replay_ring_stats {
+    uint64_t hits = 0;          // resumptions replayed from the ring
+    uint64_t misses = 0;        // resumptions falling back to a snapshot
+    uint64_t replayed = 0;      // batches replayed
+    size_t batches = 0;         // in the ring
+    size_t bytes = 0;
+};
+
+
+// The batches published last, by publish sequence (batched_tick_update.
+// publish_sequence), for the streams resuming with tick_request.resume_from.
+// Bounded by the bytes of the batches kept, their age or both; disabled
+// when neither is set.
+class replay_ring {
+public:
+    struct entry {
+        uint64_t sequence;
+        symbol_id_t symbol;
+        int64_t time_ns;
+        size_t bytes;
+        batched_tick_update ticks;
+    };
+
+    explicit replay_ring(const replay_config& config = {}) : config_(config) {}
+
+    bool enabled() const { return config_.max_bytes > 0 || config_.max_age_ms > 0; }
+
+    void add(uint64_t sequence, symbol_id_t symbol, const batched_tick_update& ticks, int64_t now_ns) {
+        if (!enabled())
+            return;
+        size_t bytes = ticks.ByteSizeLong();
+        entries_.push_back({sequence, symbol, now_ns, bytes, ticks});
+        stats_.bytes += bytes;
+        evict(now_ns);
+    }
+
+    // Whether every batch published after from is still here, latest being
+    // the sequence of the last batch published. Counted as a hit or a miss.
+    bool covers(uint64_t from, uint64_t latest, int64_t now_ns) {
+        evict(now_ns);
+        bool covered = enabled() && from <= latest &&
+            (from == latest || (!entries_.empty() && entries_.front().sequence <= from + 1));
+        ++(covered ? stats_.hits : stats_.misses);
+        return covered;
+    }
+
+    // f(entry) for the batches published after from
+    template <typename F>
+    void replay(uint64_t from, F&& f) {
+        auto it = std::lower_bound(entries_.begin(), entries_.end(), from + 1,
+            [] (const entry& e, uint64_t sequence) { return e.sequence < sequence; });
+        for (; it != entries_.end(); ++it) {
+            ++stats_.replayed;
+            f(*it);
+        }
+    }
+
+    const replay_ring_stats& stats() const { return stats_; }
+
+private:
+    void evict(int64_t now_ns) {
+        int64_t max_age_ns = config_.max_age_ms * 1'000'000;
+        while (!entries_.empty() &&
+               ((config_.max_bytes > 0 && stats_.bytes > config_.max_bytes) ||
+                (max_age_ns > 0 && now_ns - entries_.front().time_ns > max_age_ns))) {
+            stats_.bytes -= entries_.front().bytes;
+            entries_.pop_front();
+        }
+        stats_.batches = entries_.size();
+    }
+
+    replay_config config_;
+    std::deque<entry> entries_;
+    replay_ring_stats stats_;
+};
+
+
+#endif  // _REPLAY_RING_H_
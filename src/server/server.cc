@@ -1,6 +1,9 @@
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <memory>
+#include <stdexcept>
 #include <string>
 
 #include "absl/flags/flag.h"
@@ -11,14 +14,31 @@
 
 
 #include "poco_init.h"
-#include "../market_protocol/link_binance.h"
-#include "../market_protocol/link_kraken.h"
-#include "../market_protocol/link_cryptocom.h"
+#include "../market_protocol/link_registry.h"
 #include "aggregator_server.h"
+#include "callback_server.h"
 
 #include "../logger.h"
+#include "../binlog.h"
 
 ABSL_FLAG(uint16_t, port, 50051, "Server port for the service");
+ABSL_FLAG(bool, async_log, true, "Write the log file from a background thread");
+ABSL_FLAG(bool, binary_log, false, "Log the hot path in binary to <name>.binlog, read it with logdecode");
+ABSL_FLAG(std::string, config, "", "Exchange link config file (json), built-in BTCUSDT links if empty");
+ABSL_FLAG(uint32_t, client_queue_limit, 1024, "Batches queued per client before the slow client policy applies");
+ABSL_FLAG(std::string, slow_client_policy, "conflate", "drop_oldest, conflate or disconnect");
+ABSL_FLAG(uint32_t, cq_threads, 0, "Completion queues, each drained by its own thread; 0 to serve every stream from the main loop");
+ABSL_FLAG(bool, callback_api, false, "Serve the batched stream and the snapshot with gRPC's callback API instead of completion queues");
+ABSL_FLAG(uint32_t, batch_window_us, 0, "Merge the batches of a symbol from every exchange for that long before publishing, 0 to publish each one as it comes");
+ABSL_FLAG(uint32_t, batch_window_updates, 1000, "Publish a batch window early once it holds that many updates");
+ABSL_FLAG(uint32_t, replay_mb, 0, "Megabytes of the latest batches kept to replay to the streams resuming, 0 for no size bound");
+ABSL_FLAG(uint32_t, replay_seconds, 0, "Seconds of the latest batches kept to replay to the streams resuming, 0 for no age bound; no replay if both are 0");
+ABSL_FLAG(std::string, shm_ring, "", "Also write every batch to this shared memory ring (/dev/shm) for the clients on this host, none if empty");
+ABSL_FLAG(uint32_t, shm_slots, 4096, "Batches the shared memory ring holds before a reader that far behind loses them");
+ABSL_FLAG(uint32_t, shm_slot_kb, 16, "Kilobytes per shared memory ring slot, larger batches are not written to the ring");
+ABSL_FLAG(std::string, shm_bbo, "", "Also keep the consolidated best bid / ask of every symbol in this shared memory table (/dev/shm), none if empty");
+ABSL_FLAG(uint32_t, shm_bbo_symbols, 1024, "Symbols the shared memory bbo table holds, the others are not written");
+ABSL_FLAG(uint32_t, stats_interval, 10, "Seconds between client queue stats in the log, 0 to disable");
 
 using namespace market_protocol;
 
@@ -26,31 +46,99 @@ int main(int argc, char **argv)
 {
     absl::ParseCommandLine(argc, argv);
     absl::InitializeLog();
-    file_log_sink logger("server");
+    auto logger = make_log_sink("server", absl::GetFlag(FLAGS_async_log));
+    auto binary_logger = binlog::make_writer("server", absl::GetFlag(FLAGS_binary_log));
 
     PocoInit pocoinit("server-poco"); // poco for web socket. 
     
-    aggregator_server server(absl::GetFlag(FLAGS_port));    // grpc service
+    client_queue_config queue_config;
+    queue_config.max_depth = std::max<uint32_t>(1, absl::GetFlag(FLAGS_client_queue_limit));
+    if (!parse_slow_client_policy(absl::GetFlag(FLAGS_slow_client_policy), queue_config.policy)) {
+        LOG(ERROR) << "unknown slow client policy " << absl::GetFlag(FLAGS_slow_client_policy);
+        return 1;
+    }
+    // given to the server as it starts, the streams use it from then on
+    aggregator_server_config server_config;
+    bool callback_api = absl::GetFlag(FLAGS_callback_api);
+    if (absl::GetFlag(FLAGS_batch_window_us) > 0) {
+        if (!callback_api) {
+            server_config.batch_window.window_us = absl::GetFlag(FLAGS_batch_window_us);
+            server_config.batch_window.max_updates = std::max<uint32_t>(1, absl::GetFlag(FLAGS_batch_window_updates));
+        } else {
+            LOG(WARNING) << "batch_window_us is not supported with the callback API, ignored";
+        }
+    }
+    if (absl::GetFlag(FLAGS_replay_mb) > 0 || absl::GetFlag(FLAGS_replay_seconds) > 0) {
+        if (!callback_api) {
+            server_config.replay.max_bytes = (size_t) absl::GetFlag(FLAGS_replay_mb) << 20;
+            server_config.replay.max_age_ms = absl::GetFlag(FLAGS_replay_seconds) * 1000LL;
+        } else {
+            LOG(WARNING) << "replay is not supported with the callback API, resuming streams get a snapshot";
+        }
+    }
+    if (!absl::GetFlag(FLAGS_shm_ring).empty()) {
+        if (!callback_api) {
+            server_config.shm_ring_name = absl::GetFlag(FLAGS_shm_ring);
+            server_config.shm_ring_config.slots = std::max<uint32_t>(1, absl::GetFlag(FLAGS_shm_slots));
+            server_config.shm_ring_config.slot_bytes = (size_t) absl::GetFlag(FLAGS_shm_slot_kb) << 10;
+        } else {
+            LOG(WARNING) << "shm_ring is not supported with the callback API, ignored";
+        }
+    }
+    if (!absl::GetFlag(FLAGS_shm_bbo).empty()) {
+        if (!callback_api) {
+            server_config.shm_bbo_name = absl::GetFlag(FLAGS_shm_bbo);
+            server_config.shm_bbo_symbols = absl::GetFlag(FLAGS_shm_bbo_symbols);
+        } else {
+            LOG(WARNING) << "shm_bbo is not supported with the callback API, ignored";
+        }
+    }
 
-    // setup the web sockets to exchange
-    binance_link binance("BTCUSDT", "btcusdt");
-    kraken_link kraken("BTCUSDT", "BTC/USDT");
-    cryptocom_link crytocom("BTCUSDT", "BTC_USDT");
+    // One connection per configured link. Created before the server starts:
+    // they intern the configured symbols, which the streams subscribing look up.
+    symbol_registry symbols;
+    std::string config_file = absl::GetFlag(FLAGS_config);
+    link_registry links;
+    links.create(symbols, config_file.empty() ? default_link_config() : load_link_config(config_file));
 
-    binance.set_callback(server.get_process_ticks());
-    kraken.set_callback(server.get_process_ticks());
-    crytocom.set_callback(server.get_process_ticks());
+    std::unique_ptr<aggregator_server> cq_server;
+    std::unique_ptr<callback_server> cb_server;
+    size_t cq_threads = absl::GetFlag(FLAGS_cq_threads);
+    // grpc service
+    if (callback_api) {
+        cb_server = std::make_unique<callback_server>(absl::GetFlag(FLAGS_port), symbols, queue_config);
+    } else {
+        try {
+            cq_server = std::make_unique<aggregator_server>(absl::GetFlag(FLAGS_port), symbols, queue_config, cq_threads,
+                server_config);
+        } catch (const std::runtime_error& ex) {
+            LOG(ERROR) << ex.what();
+            return 1;
+        }
+    }
 
-    binance.connect();
-    kraken.connect();
-    crytocom.connect();
+    // the web sockets to the exchanges start once the server serves the ticks
+    links.set_callback(cq_server ? cq_server->get_process_ticks() : cb_server->get_process_ticks());
+    links.connect();
 
+    auto stats_interval = std::chrono::seconds(absl::GetFlag(FLAGS_stats_interval));
+    auto next_stats = std::chrono::steady_clock::now() + stats_interval;
     while (true)
     {
-        server.poll_non_block();
-        binance.poll();
-        kraken.poll();
-        crytocom.poll();
+        // the callback API and the queue threads run the streams on their own threads
+        if (cq_server && cq_threads == 0)
+            cq_server->poll_non_block();
+        links.poll();
+        if (cq_server)
+            cq_server->poll_batch_window();
+
+        if (stats_interval.count() > 0 && std::chrono::steady_clock::now() >= next_stats) {
+            if (cq_server)
+                cq_server->log_client_stats();
+            else
+                cb_server->log_client_stats();
+            next_stats += stats_interval;
+        }
     }
 
     return 0;
@@ -0,0 +1,124 @@
+#ifndef _SUBSCRIBER_INDEX_H_
+#define _SUBSCRIBER_INDEX_H_
+
+#include <algorithm>
+#include <vector>
+
+#include "../common.h"
+#include "../symbol_registry.h"
+
+
+// What one stream asked for. No symbol means every symbol, no exchange
+// means every exchange. A depth above 0 asks for the consolidated top
+// levels instead of the exchange batches.
+struct subscription {
+    std::vector<symbol_id_t> symbols;
+    std::vector<uint32_t> exchanges;
+    uint32_t depth = 0;
+
+    bool wants(uint32_t exchange) const {
+        return exchanges.empty() || std::find(exchanges.begin(), exchanges.end(), exchange) != exchanges.end();
+    }
+};
+
+// Subscribers indexed by symbol and exchange, so a batch only visits the
+// streams interested in it: the dispatch cost is the number of those
+// subscribers, not the number of clients.
+template <typename Client>
+class subscriber_index {
+private:
+    using list = std::vector<Client*>;
+
+    struct symbol_subscribers {
+        list all_exchanges;
+        list by_exchange[(uint32_t) exchange_t::total];
+    };
+
+    list all_;                                  // every subscriber
+    symbol_subscribers any_symbol_;             // subscribed to every symbol
+    std::vector<symbol_subscribers> symbols_;   // by symbol id
+
+    template <typename F>
+    static void visit(list& l, F& f) {
+        for (size_t i = l.size(); i-- > 0;)
+            f(l[i]);
+    }
+
+    static void erase(list& l, Client* client) {
+        auto it = std::find(l.begin(), l.end(), client);
+        if (it != l.end()) l.erase(it);
+    }
+
+    // the lists a subscription puts a client in
+    template <typename F>
+    void for_each_list(const subscription& sub, F&& f) {
+        if (sub.depth > 0)
+            return;     // fed by its depth views
+        auto add_to = [&] (symbol_subscribers& s) {
+            if (sub.exchanges.empty()) {
+                f(s.all_exchanges);
+                return;
+            }
+            for (uint32_t exchange : sub.exchanges)
+                if (exchange < (uint32_t) exchange_t::total)
+                    f(s.by_exchange[exchange]);
+        };
+        if (sub.symbols.empty()) {
+            add_to(any_symbol_);
+            return;
+        }
+        for (symbol_id_t symbol : sub.symbols) {
+            if (symbol >= symbols_.size())
+                symbols_.resize(symbol + 1);
+            add_to(symbols_[symbol]);
+        }
+    }
+
+public:
+    void add(Client* client, const subscription& sub) {
+        all_.push_back(client);
+        for_each_list(sub, [&] (list& l) { l.push_back(client); });
+    }
+
+    void remove(Client* client, const subscription& sub) {
+        erase(all_, client);
+        for_each_list(sub, [&] (list& l) { erase(l, client); });
+    }
+
+    // Calls f on every subscriber of (symbol, exchange). Backwards, so f may
+    // remove the client it is called on.
+    template <typename F>
+    void for_each(symbol_id_t symbol, uint32_t exchange, F&& f) {
+        for_each_all_exchanges(symbol, f);
+        for_each_exchange_only(symbol, exchange, f);
+    }
+
+    // the subscribers of every exchange of the symbol
+    template <typename F>
+    void for_each_all_exchanges(symbol_id_t symbol, F&& f) {
+        visit(any_symbol_.all_exchanges, f);
+        if (symbol < symbols_.size())
+            visit(symbols_[symbol].all_exchanges, f);
+    }
+
+    // the subscribers of the symbol restricted to some exchanges, this one among them
+    template <typename F>
+    void for_each_exchange_only(symbol_id_t symbol, uint32_t exchange, F&& f) {
+        if (exchange >= (uint32_t) exchange_t::total)
+            return;
+        visit(any_symbol_.by_exchange[exchange], f);
+        if (symbol < symbols_.size())
+            visit(symbols_[symbol].by_exchange[exchange], f);
+    }
+
+    const list& all() const {
+        return all_;
+    }
+
+    bool empty() const {
+        return all_.empty();
+    }
+};
+
+
+#endif  // _SUBSCRIBER_INDEX_H_
@@ -0,0 +1,272 @@
+#ifndef _SHM_BBO_H_
+#define _SHM_BBO_H_
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <thread>
+
+#include "common.h"
+#include "logger.h"
+#include "shm_ring.h"
+#include "symbol_registry.h"
+
+
+// The consolidated best bid / ask of every symbol in POSIX shared memory
+// (/dev/shm/<name>), for the processes on the same host that need nothing
+// else: they read it when they want, with no stream and no message to
+// process.
+//
+// One entry per symbol id, each under its own seqlock: the writer makes the
+// sequence odd, writes the quote and makes it even again. A reader copies
+// the quote between two loads of the sequence and keeps it if they are the
+// same even number, otherwise it reads again. The writer never waits and
+// only writes an entry when its quote changes.
+namespace shm_bbo {
+
+constexpr uint64_t magic = 0x4f42424d48534741;  // "AGSHMBBO"
+constexpr uint32_t version = 1;
+constexpr uint32_t venues = (uint32_t) exchange_t::total;
+constexpr size_t max_name = 31;
+
+// qty[0] is the total, qty[exchange] the quantity of each exchange at that price
+struct side {
+    double price;
+    double qty[venues];
+};
+
+struct quote {
+    side bid;
+    side ask;
+    int64_t tick_id;            // of the batch that changed it
+    uint64_t publish_sequence;  // of that batch, as in the streams
+};
+
+// zeroed by ftruncate, magic written last
+struct alignas(64) table_header {
+    std::atomic<uint64_t> magic;
+    uint32_t version;
+    uint32_t venues;
+    uint64_t capacity;                      // entries
+    alignas(64) std::atomic<uint32_t> closed;   // the writer is gone
+};
+
+struct alignas(64) entry {
+    std::atomic<uint64_t> sequence;     // odd while being written, 0 for never
+    char symbol[max_name + 1];          // set before the first quote
+    // the quote, word by word: read while it may be written
+    std::atomic<uint64_t> words[sizeof(quote) / sizeof(uint64_t)];
+};
+
+static_assert(sizeof(quote) % sizeof(uint64_t) == 0, "a quote is copied in words");
+
+// the mapping of a table, shared by the writer and the readers
+class mapping {
+public:
+    mapping() = default;
+    mapping(const mapping&) = delete;
+    mapping& operator=(const mapping&) = delete;
+
+    ~mapping() {
+        if (base_)
+            munmap(base_, size_);
+    }
+
+    bool is_open() const { return base_ != nullptr; }
+    size_t capacity() const { return header()->capacity; }
+
+protected:
+    bool map(int fd, size_t size, int prot) {
+        void* base = mmap(nullptr, size, prot, MAP_SHARED, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED)
+            return false;
+        base_ = static_cast<char*>(base);
+        size_ = size;
+        return true;
+    }
+
+    table_header* header() const { return reinterpret_cast<table_header*>(base_); }
+
+    entry* at(size_t index) const {
+        return reinterpret_cast<entry*>(base_ + sizeof(table_header)) + index;
+    }
+
+    char* base_ = nullptr;
+    size_t size_ = 0;
+};
+
+
+class writer : public mapping {
+public:
+    ~writer() {
+        if (!is_open())
+            return;
+        header()->closed.store(1, std::memory_order_release);
+        shm_unlink(name_.c_str());
+    }
+
+    // A new table of capacity symbols, replacing one of the same name: the
+    // readers of the old one keep their mapping, they see it closed.
+    bool open(const std::string& name, size_t capacity) {
+        name_ = shm_ring::path(name);
+        capacity = std::max<size_t>(capacity, 1);
+        size_t size = sizeof(table_header) + capacity * sizeof(entry);
+        shm_unlink(name_.c_str());
+        int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0 || ftruncate(fd, size) != 0 || !map(fd, size, PROT_READ | PROT_WRITE)) {
+            LOG(ERROR) << "shared memory bbo table " << name_ << ": " << std::strerror(errno);
+            if (fd >= 0)
+                shm_unlink(name_.c_str());
+            return false;
+        }
+        table_header* h = header();
+        h->version = version;
+        h->venues = venues;
+        h->capacity = capacity;
+        h->magic.store(magic, std::memory_order_release);
+        LOG(INFO) << "shared memory bbo table " << name_ << ": " << capacity << " symbols";
+        return true;
+    }
+
+    bool fits(symbol_id_t symbol_id) const { return symbol_id < capacity(); }
+
+    bool named(symbol_id_t symbol_id) const { return at(symbol_id)->symbol[0] != '\0'; }
+
+    // once, before the first quote of the symbol
+    void name(symbol_id_t symbol_id, const std::string& symbol) {
+        size_t n = std::min(symbol.size(), max_name);
+        memcpy(at(symbol_id)->symbol, symbol.data(), n);
+        at(symbol_id)->symbol[n] = '\0';
+    }
+
+    // false if the quote is the one already there, tick_id and
+    // publish_sequence aside
+    bool update(symbol_id_t symbol_id, const quote& q) {
+        entry* e = at(symbol_id);
+        uint64_t sequence = e->sequence.load(std::memory_order_relaxed);
+        if (sequence != 0) {
+            quote last = load(*e);
+            if (memcmp(&last.bid, &q.bid, sizeof(side)) == 0 && memcmp(&last.ask, &q.ask, sizeof(side)) == 0)
+                return false;
+        }
+        e->sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        uint64_t words[sizeof(quote) / sizeof(uint64_t)];
+        memcpy(words, &q, sizeof(quote));
+        for (size_t i = 0; i < std::size(words); ++i)
+            e->words[i].store(words[i], std::memory_order_relaxed);
+        e->sequence.store(sequence + 2, std::memory_order_release);
+        return true;
+    }
+
+private:
+    // the writer's own entry, never torn for it
+    static quote load(const entry& e) {
+        uint64_t words[sizeof(quote) / sizeof(uint64_t)];
+        for (size_t i = 0; i < std::size(words); ++i)
+            words[i] = e.words[i].load(std::memory_order_relaxed);
+        quote q;
+        memcpy(&q, words, sizeof(quote));
+        return q;
+    }
+
+    std::string name_;
+};
+
+
+class reader : public mapping {
+public:
+    // Maps an existing table.
+    bool open(const std::string& name) {
+        std::string p = shm_ring::path(name);
+        int fd = shm_open(p.c_str(), O_RDONLY, 0);
+        struct stat st;
+        if (fd >= 0 && (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(table_header))) {
+            close(fd);
+            fd = -1;
+        }
+        if (fd < 0 || !map(fd, st.st_size, PROT_READ)) {
+            LOG(WARNING) << "shared memory bbo table " << p << ": " << std::strerror(errno);
+            return false;
+        }
+        const table_header* h = header();
+        if (h->magic.load(std::memory_order_acquire) != magic || h->version != version ||
+            h->venues != venues || sizeof(table_header) + h->capacity * sizeof(entry) > (size_t) st.st_size) {
+            LOG(WARNING) << "shared memory bbo table " << p << ": not a table of this version";
+            munmap(base_, size_);
+            base_ = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+    // The entry of symbol, -1 until the server has quoted it. A scan: once
+    // per symbol, not per read.
+    int64_t find(const std::string& symbol) const {
+        for (size_t i = 0; i < capacity(); ++i) {
+            const entry* e = at(i);
+            if (e->sequence.load(std::memory_order_acquire) != 0 &&
+                strncmp(e->symbol, symbol.c_str(), max_name) == 0 && symbol.size() <= max_name)
+                return (int64_t) i;
+        }
+        return -1;
+    }
+
+    // Changes each time the quote of the entry does: a reader polling
+    // compares it with the one of its last read before reading again.
+    uint64_t sequence(size_t index) const {
+        return at(index)->sequence.load(std::memory_order_acquire);
+    }
+
+    // One attempt: false if the entry was being written, or never was.
+    // sequence is that of the quote read.
+    bool try_read(size_t index, quote& out, uint64_t& sequence) const {
+        const entry* e = at(index);
+        sequence = e->sequence.load(std::memory_order_acquire);
+        if (sequence == 0 || sequence & 1)
+            return false;
+        uint64_t words[sizeof(quote) / sizeof(uint64_t)];
+        for (size_t i = 0; i < std::size(words); ++i)
+            words[i] = e->words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (e->sequence.load(std::memory_order_relaxed) != sequence)
+            return false;
+        memcpy(&out, words, sizeof(quote));
+        return true;
+    }
+
+    // The latest quote of the entry, retrying while it is being written.
+    // False if it was never written. Yields now and then: a writer preempted
+    // in the middle of a quote needs the core back to finish it.
+    bool read(size_t index, quote& out, uint64_t& sequence) const {
+        for (uint32_t attempt = 1; !try_read(index, out, sequence); ++attempt) {
+            if (at(index)->sequence.load(std::memory_order_relaxed) == 0)
+                return false;
+            if (attempt % 64 == 0)
+                std::this_thread::yield();
+        }
+        return true;
+    }
+
+    bool read(size_t index, quote& out) const {
+        uint64_t sequence;
+        return read(index, out, sequence);
+    }
+
+    // the server has gone, the quotes are its last ones
+    bool closed() const { return header()->closed.load(std::memory_order_acquire) != 0; }
+};
+
+}   // namespace shm_bbo
+
+
+#endif  // _SHM_BBO_H_
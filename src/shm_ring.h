@@ -0,0 +1,249 @@
+#ifndef _SHM_RING_H_
+#define _SHM_RING_H_
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include "logger.h"
+
+
+// The batches of the server in POSIX shared memory (/dev/shm/<name>), for the
+// clients on the same host: one writer, any number of readers, each reading
+// at its own pace without the writer knowing about them.
+//
+// A ring of fixed size slots, each holding one message and the sequence
+// number of that message (from 1). The writer never waits: it clears the
+// sequence of the slot it overwrites, writes the message, then publishes the
+// slot and the ring with release stores. A reader copies the message out and
+// checks the slot sequence again: a reader lapped by the writer finds
+// another sequence there and is told how many messages it lost (overrun).
+// A message larger than a slot still takes its sequence, the slot is marked
+// dropped instead: the numbering stays that of the writer's messages and the
+// readers learn that one is missing.
+namespace shm_ring {
+
+constexpr uint64_t magic = 0x474e525348474741;  // "AGGSHRNG"
+constexpr uint32_t version = 2;
+
+struct config {
+    size_t slots = 4096;
+    size_t slot_bytes = 16 * 1024;  // the largest message is 64 bytes less
+};
+
+// zeroed by ftruncate, magic written last
+struct alignas(64) ring_header {
+    std::atomic<uint64_t> magic;
+    uint32_t version;
+    uint64_t slots;
+    uint64_t slot_bytes;
+    alignas(64) std::atomic<uint64_t> published;   // sequence of the last message, 0 for none
+    std::atomic<uint32_t> closed;                   // the writer is gone
+};
+
+struct alignas(64) slot_header {
+    std::atomic<uint64_t> sequence;     // of the message, 0 while being written
+    uint32_t size;                      // dropped_size for a message not written
+};
+
+constexpr uint32_t dropped_size = UINT32_MAX;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared memory needs lock free atomics");
+
+inline std::string path(const std::string& name) {
+    return name.empty() || name[0] == '/' ? name : "/" + name;
+}
+
+// the mapping of a ring, shared by the writer and the readers
+class mapping {
+public:
+    mapping() = default;
+    mapping(const mapping&) = delete;
+    mapping& operator=(const mapping&) = delete;
+
+    ~mapping() {
+        if (base_)
+            munmap(base_, size_);
+    }
+
+    bool is_open() const { return base_ != nullptr; }
+    size_t slots() const { return header()->slots; }
+    size_t max_message() const { return header()->slot_bytes - sizeof(slot_header); }
+
+protected:
+    bool map(int fd, size_t size, int prot) {
+        void* base = mmap(nullptr, size, prot, MAP_SHARED, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED)
+            return false;
+        base_ = static_cast<char*>(base);
+        size_ = size;
+        return true;
+    }
+
+    ring_header* header() const { return reinterpret_cast<ring_header*>(base_); }
+
+    slot_header* slot(uint64_t sequence) const {
+        size_t index = (sequence - 1) % header()->slots;
+        return reinterpret_cast<slot_header*>(base_ + sizeof(ring_header) + index * header()->slot_bytes);
+    }
+
+    static char* data(slot_header* s) { return reinterpret_cast<char*>(s) + sizeof(slot_header); }
+
+    char* base_ = nullptr;
+    size_t size_ = 0;
+};
+
+
+class writer : public mapping {
+public:
+    ~writer() {
+        if (!is_open())
+            return;
+        header()->closed.store(1, std::memory_order_release);
+        shm_unlink(name_.c_str());
+    }
+
+    // A new ring, replacing one of the same name: the readers of the old one
+    // keep their mapping, they see it closed.
+    bool open(const std::string& name, const config& c) {
+        name_ = path(name);
+        size_t slot_bytes = (std::max(c.slot_bytes, 2 * sizeof(slot_header)) + 63) / 64 * 64;
+        size_t slots = std::max<size_t>(c.slots, 1);
+        size_t size = sizeof(ring_header) + slots * slot_bytes;
+        shm_unlink(name_.c_str());
+        int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0 || ftruncate(fd, size) != 0 || !map(fd, size, PROT_READ | PROT_WRITE)) {
+            LOG(ERROR) << "shared memory ring " << name_ << ": " << std::strerror(errno);
+            if (fd >= 0)
+                shm_unlink(name_.c_str());
+            return false;
+        }
+        // ftruncate zeroed it: every slot is empty
+        ring_header* h = header();
+        h->version = version;
+        h->slots = slots;
+        h->slot_bytes = slot_bytes;
+        h->magic.store(magic, std::memory_order_release);
+        LOG(INFO) << "shared memory ring " << name_ << ": " << slots << " slots of " << slot_bytes << " bytes";
+        return true;
+    }
+
+    // fill(char*) writes the size bytes of the next message. False if it
+    // does not fit in a slot: the message takes its sequence all the same,
+    // in a slot marked dropped.
+    template <typename F>
+    bool write(size_t size, F&& fill) {
+        bool fits = size <= max_message();
+        ring_header* h = header();
+        uint64_t sequence = h->published.load(std::memory_order_relaxed) + 1;
+        slot_header* s = slot(sequence);
+        s->sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        if (fits)
+            fill(data(s));
+        s->size = fits ? (uint32_t) size : dropped_size;
+        s->sequence.store(sequence, std::memory_order_release);
+        h->published.store(sequence, std::memory_order_release);
+        return fits;
+    }
+
+    uint64_t published() const { return header()->published.load(std::memory_order_relaxed); }
+
+private:
+    std::string name_;
+};
+
+
+enum class read_result { none, message, overrun, dropped, closed };
+
+class reader : public mapping {
+public:
+    // Maps an existing ring, read from its next message on.
+    bool open(const std::string& name) {
+        std::string p = path(name);
+        int fd = shm_open(p.c_str(), O_RDONLY, 0);
+        struct stat st;
+        if (fd >= 0 && (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(ring_header))) {
+            close(fd);
+            fd = -1;
+        }
+        if (fd < 0 || !map(fd, st.st_size, PROT_READ)) {
+            LOG(WARNING) << "shared memory ring " << p << ": " << std::strerror(errno);
+            return false;
+        }
+        const ring_header* h = header();
+        if (h->magic.load(std::memory_order_acquire) != magic ||
+            h->version != version || sizeof(ring_header) + h->slots * h->slot_bytes > (size_t) st.st_size) {
+            LOG(WARNING) << "shared memory ring " << p << ": not a ring of this version";
+            munmap(base_, size_);
+            base_ = nullptr;
+            return false;
+        }
+        next_ = h->published.load(std::memory_order_acquire) + 1;
+        return true;
+    }
+
+    // The next message into out. On overrun, lost is how many messages are
+    // gone and the next read goes on from the oldest one still there. A
+    // message the writer dropped is read as dropped, lost 1.
+    read_result read(std::string& out, uint64_t& lost) {
+        const ring_header* h = header();
+        uint64_t published = h->published.load(std::memory_order_acquire);
+        if (next_ > published)
+            return h->closed.load(std::memory_order_acquire) ? read_result::closed : read_result::none;
+        if (published - next_ >= h->slots)
+            return skip(published - h->slots + 1, lost);
+
+        slot_header* s = slot(next_);
+        if (s->sequence.load(std::memory_order_acquire) == next_) {
+            uint32_t size = s->size;
+            if (size != dropped_size)
+                out.assign(data(s), std::min<size_t>(size, max_message()));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s->sequence.load(std::memory_order_relaxed) == next_) {
+                ++next_;
+                if (size != dropped_size)
+                    return read_result::message;
+                lost = 1;
+                return read_result::dropped;
+            }
+        }
+        // overwritten under us: the writer is a whole ring ahead
+        published = h->published.load(std::memory_order_acquire);
+        return skip(std::max(next_ + 1, published - std::min<uint64_t>(published, h->slots) + 1), lost);
+    }
+
+    // sequence of the next message read
+    uint64_t next() const { return next_; }
+
+    // the oldest message still in the ring
+    uint64_t oldest() const {
+        uint64_t published = header()->published.load(std::memory_order_acquire);
+        return published < header()->slots ? 1 : published - header()->slots + 1;
+    }
+
+    // reads on from message next, an overrun if it is no longer there
+    void seek(uint64_t next) { next_ = next; }
+
+private:
+    read_result skip(uint64_t to, uint64_t& lost) {
+        lost = to - next_;
+        next_ = to;
+        return read_result::overrun;
+    }
+
+    uint64_t next_ = 1;
+};
+
+}   // namespace shm_ring
+
+
+#endif  // _SHM_RING_H_
@@ -0,0 +1,73 @@
+#ifndef _SYMBOL_REGISTRY_H_
+#define _SYMBOL_REGISTRY_H_
+
+#include <stdint.h>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+
+using symbol_id_t = uint32_t;
+constexpr symbol_id_t invalid_symbol_id = std::numeric_limits<symbol_id_t>::max();
+
+// price and quantity increments of a symbol, 0 when not configured
+struct symbol_sizes {
+    double tick_size = 0;
+    double lot_size = 0;
+};
+
+// Internal symbols known to this process.
+// Ids are dense and start from 0, so the publishing side can use them as
+// vector indices instead of hashing the symbol name on every message. They
+// are also what the streams carry (ListSymbols gives the names).
+// Thread safe: the links intern the symbols of their config as the server
+// starts, the server shards look up those their streams subscribe to.
+class symbol_registry {
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, symbol_id_t> ids_;
+    std::deque<std::string> names_;     // a name stays where it is once interned
+    std::deque<symbol_sizes> sizes_;
+
+public:
+    symbol_id_t intern(const std::string& symbol) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto [it, inserted] = ids_.emplace(symbol, (symbol_id_t) names_.size());
+        if (inserted) {
+            names_.push_back(symbol);
+            sizes_.emplace_back();
+        }
+        return it->second;
+    }
+
+    void set_sizes(symbol_id_t id, const symbol_sizes& sizes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sizes_[id] = sizes;
+    }
+
+    symbol_sizes sizes(symbol_id_t id) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return sizes_[id];
+    }
+
+    symbol_id_t find(const std::string& symbol) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = ids_.find(symbol);
+        return it != ids_.end() ? it->second : invalid_symbol_id;
+    }
+
+    const std::string& name(symbol_id_t id) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return names_[id];
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return names_.size();
+    }
+};
+
+
+#endif // _SYMBOL_REGISTRY_H_
@@ -0,0 +1,228 @@
+#ifndef _STREAM_TEST_UTIL_H_
+#define _STREAM_TEST_UTIL_H_
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+#include "../server/aggregator_server.h"
+#include "../client/orderbook.h"
+#include "../common.h"
+
+
+// Helpers of the tests running an aggregator_server and its clients in process.
+namespace stream_test {
+
+using agg_proto::agg_service;
+using agg_proto::tick_request;
+using agg_proto::batched_tick_update;
+using order_book::extended_book;
+
+// the symbol table of the in-process servers, BTCUSDT (what make_batch publishes) is symbol 0
+inline symbol_registry& test_symbols() {
+    static symbol_registry symbols;
+    symbols.intern("BTCUSDT");
+    return symbols;
+}
+
+inline batched_tick_update make_batch(std::mt19937& rng, uint32_t exchange, int64_t tick_id, int levels) {
+    std::uniform_int_distribution<int> offset(1, 100);
+    std::uniform_real_distribution<double> qty(0.1, 5);
+    batched_tick_update ticks;
+    ticks.set_symbol_id(0);     // BTCUSDT
+    ticks.set_exchange(exchange);
+    ticks.set_tick_id(tick_id);
+    for (int i = 0; i < levels; ++i) {
+        auto& tick = *ticks.add_updates();
+        bool bid = i % 2 == 0;
+        tick.set_side((uint32_t) (bid ? side_t::bid : side_t::ask));
+        tick.set_price(bid ? 100000 - offset(rng) : 100000 + offset(rng));
+        tick.set_quantity(i % 5 == 0 ? 0 : qty(rng));
+        tick.set_tick_id(tick_id);
+    }
+    return ticks;
+}
+
+// A batched stream subscriber that only reads when asked to.
+class stream_client {
+public:
+    explicit stream_client(uint16_t port, bool conflate = false)
+        : stream_client(port, make_request(conflate)) {}
+
+    stream_client(uint16_t port, const tick_request& request) {
+        grpc::ChannelArguments args;
+        // keep the flow control window small, so the server queue fills up
+        args.SetInt(GRPC_ARG_HTTP2_BDP_PROBE, 0);
+        auto channel = grpc::CreateCustomChannel(absl::StrFormat("localhost:%d", port), grpc::InsecureChannelCredentials(), args);
+        stub_ = agg_service::NewStub(channel);
+        reader_ = stub_->PrepareAsyncTickBatchedStreamRequest(&ctx_, request, &cq_);
+        reader_->StartCall(&started_);
+    }
+
+    ~stream_client() {
+        ctx_.TryCancel();
+        cq_.Shutdown();
+        void* tag;
+        bool ok;
+        while (cq_.Next(&tag, &ok)) {}
+    }
+
+    // one step of the client, false once the stream is over
+    bool poll(extended_book& book, batched_tick_update& last) {
+        void* tag;
+        bool ok;
+        auto deadline = std::chrono::system_clock::now() + std::chrono::milliseconds(1);
+        if (cq_.AsyncNext(&tag, &ok, deadline) != grpc::CompletionQueue::GOT_EVENT)
+            return true;
+        if (tag == &finished_)
+            return false;
+        if (!ok) {
+            reader_->Finish(&status_, &finished_);
+            return true;
+        }
+        if (tag == &read_) {
+            if (ticks_.batches_size() == 0)
+                receive(ticks_, book, last);
+            for (const auto& batch : ticks_.batches())
+                receive(batch, book, last);
+            ++reads_;
+        }
+        reader_->Read(&ticks_, &read_);
+        return true;
+    }
+
+    const grpc::Status& status() const { return status_; }
+
+    // messages read, several batches each when coalesced
+    size_t reads() const { return reads_; }
+
+    // every batch read, without its updates
+    const std::vector<batched_tick_update>& received() const { return received_; }
+
+    // updates of the largest batch read
+    int max_updates() const { return max_updates_; }
+
+    // the book of each symbol read, for the streams of several symbols
+    const std::map<uint32_t, extended_book>& books() const { return books_; }
+
+private:
+    void receive(const batched_tick_update& ticks, extended_book& book, batched_tick_update& last) {
+        if (ticks.has_levels()) {
+            batched_tick_update decoded;
+            wire_codec::decode(ticks, decoded);
+            receive(decoded, book, last);
+            return;
+        }
+        book.update_ticks(ticks);
+        books_[ticks.symbol_id()].update_ticks(ticks);
+        max_updates_ = std::max(max_updates_, ticks.updates_size());
+        received_.push_back(ticks);
+        received_.back().clear_updates();
+        last = ticks;
+    }
+
+    static tick_request make_request(bool conflate) {
+        tick_request request;
+        request.set_symbol("BTCUSDT");
+        request.set_conflate(conflate);
+        return request;
+    }
+
+    std::unique_ptr<agg_service::Stub> stub_;
+    grpc::ClientContext ctx_;
+    grpc::CompletionQueue cq_;
+    std::unique_ptr<grpc::ClientAsyncReader<batched_tick_update>> reader_;
+    batched_tick_update ticks_;
+    grpc::Status status_;
+    std::vector<batched_tick_update> received_;
+    std::map<uint32_t, extended_book> books_;
+    size_t reads_ = 0;
+    int max_updates_ = 0;
+    int started_, read_, finished_;
+};
+
+// batches the stream lost, from the sequence numbers of those received
+inline uint64_t missing_sequences(const std::vector<batched_tick_update>& received) {
+    uint64_t missing = 0, last = 0;
+    for (const auto& ticks : received) {
+        missing += ticks.sequence() - last - 1;
+        last = ticks.sequence();
+    }
+    return missing;
+}
+
+// batches whose publish_sequence is lower than that of a batch received before
+inline uint64_t publish_sequence_regressions(const std::vector<batched_tick_update>& received) {
+    uint64_t regressions = 0, last = 0;
+    for (const auto& ticks : received) {
+        if (ticks.publish_sequence() == 0)
+            continue;
+        regressions += ticks.publish_sequence() < last;
+        last = std::max(last, ticks.publish_sequence());
+    }
+    return regressions;
+}
+
+inline void wait_connected(aggregator_server& server, size_t clients = 1) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (server.clients().size() < clients && std::chrono::steady_clock::now() < deadline)
+        server.poll_non_block();
+    ASSERT_EQ(server.clients().size(), clients);
+}
+
+// publishes n batches alternating between two exchanges, without the client reading
+inline void publish(aggregator_server& server, extended_book& reference, std::mt19937& rng, int64_t& tick_id, int n,
+    int snapshot_at = -1) {
+    for (int i = 0; i < n; ++i) {
+        auto ticks = make_batch(rng, 1 + i % 2, ++tick_id, 200);
+        if (i == snapshot_at)
+            ticks.set_flag((uint64_t) updata_flag_t::snapshot);
+        reference.update_ticks(ticks);
+        server.process_tick(0, ticks);
+        for (int j = 0; j < 10; ++j)
+            server.poll_non_block();
+    }
+}
+
+inline void expect_same_levels(const extended_book& book, const extended_book& reference) {
+    EXPECT_DOUBLE_EQ(book.best_bid().price, reference.best_bid().price);
+    // the exchanges are interleaved differently, the total quantity can differ in the last bits
+    EXPECT_NEAR(book.best_bid().notional, reference.best_bid().notional, 1e-6);
+    EXPECT_DOUBLE_EQ(book.best_ask().price, reference.best_ask().price);
+    EXPECT_NEAR(book.best_ask().notional, reference.best_ask().notional, 1e-6);
+    std::vector<double> bands = {1e5, 1e6, 1e7};
+    EXPECT_EQ(book.volume_band_bids(bands), reference.volume_band_bids(bands));
+    EXPECT_EQ(book.volume_band_asks(bands), reference.volume_band_asks(bands));
+}
+
+// the client catches up and ends with the same book as the publisher
+inline void expect_same_book(aggregator_server& server, stream_client& client, const extended_book& reference, int64_t tick_id) {
+    // conflated batches carry the tick_id of the last batch merged
+    extended_book book;
+    batched_tick_update last;
+    int64_t last_tick_id[3] = {};
+    size_t seen = client.received().size();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while ((last_tick_id[1] != tick_id - 1 || last_tick_id[2] != tick_id) && std::chrono::steady_clock::now() < deadline) {
+        server.poll_non_block();
+        client.poll(book, last);
+        // a coalesced read brings several batches
+        for (; seen < client.received().size(); ++seen)
+            last_tick_id[client.received()[seen].exchange()] = client.received()[seen].tick_id();
+    }
+    ASSERT_EQ(last_tick_id[1], tick_id - 1);
+    ASSERT_EQ(last_tick_id[2], tick_id);
+
+    expect_same_levels(book, reference);
+}
+
+}   // namespace stream_test
+
+
+#endif  // _STREAM_TEST_UTIL_H_
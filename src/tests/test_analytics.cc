@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+
+#include "stream_test_util.h"
+
+
+using namespace stream_test;
+
+namespace {
+
+const uint16_t port = 50165;
+
+analytics_request make_request(std::vector<double> volume_bands, std::vector<int> price_bands) {
+    analytics_request request;
+    request.set_symbol("BTCUSDT");
+    for (double band : volume_bands)
+        request.add_volume_bands(band);
+    for (int bps : price_bands)
+        request.add_price_bands(bps);
+    return request;
+}
+
+// An AnalyticsStreamRequest subscriber keeping the last update read.
+class analytics_client {
+public:
+    analytics_client(uint16_t port, const analytics_request& request) {
+        auto channel = grpc::CreateChannel(absl::StrFormat("localhost:%d", port), grpc::InsecureChannelCredentials());
+        stub_ = agg_service::NewStub(channel);
+        reader_ = stub_->PrepareAsyncAnalyticsStreamRequest(&ctx_, request, &cq_);
+        reader_->StartCall(&started_);
+    }
+
+    ~analytics_client() {
+        ctx_.TryCancel();
+        cq_.Shutdown();
+        void* tag;
+        bool ok;
+        while (cq_.Next(&tag, &ok)) {}
+    }
+
+    // one step of the client, false once the stream is over
+    bool poll() {
+        void* tag;
+        bool ok;
+        if (cq_.AsyncNext(&tag, &ok, gpr_inf_past(GPR_CLOCK_MONOTONIC)) != grpc::CompletionQueue::GOT_EVENT)
+            return true;
+        if (tag == &finished_)
+            return false;
+        if (!ok) {
+            reader_->Finish(&status_, &finished_);
+            return true;
+        }
+        if (tag == &read_) {
+            last_ = update_;
+            ++received_;
+        }
+        reader_->Read(&update_, &read_);
+        return true;
+    }
+
+    const analytics_update& last() const { return last_; }
+    size_t received() const { return received_; }
+    const grpc::Status& status() const { return status_; }
+
+private:
+    std::unique_ptr<agg_service::Stub> stub_;
+    grpc::ClientContext ctx_;
+    grpc::CompletionQueue cq_;
+    std::unique_ptr<grpc::ClientAsyncReader<analytics_update>> reader_;
+    analytics_update update_;
+    analytics_update last_;
+    size_t received_ = 0;
+    grpc::Status status_;
+    int started_, read_, finished_;
+};
+
+bool same_figures(const analytics_update& update, const extended_book& reference,
+    const std::vector<double>& volume_bands, const std::vector<int>& price_bands) {
+    auto as_vector = [] (const auto& repeated) { return std::vector<double>(repeated.begin(), repeated.end()); };
+    double bid = reference.best_bid().price;
+    double ask = reference.best_ask().price;
+    return update.best_bid() == bid && update.best_ask() == ask
+        && as_vector(update.bid_volume_bands()) == (volume_bands.empty() ? std::vector<double>() : reference.volume_band_bids(volume_bands))
+        && as_vector(update.ask_volume_bands()) == (volume_bands.empty() ? std::vector<double>() : reference.volume_band_asks(volume_bands))
+        && as_vector(update.bid_price_bands()) == (price_bands.empty() ? std::vector<double>() : extended_book::price_band(bid, price_bands))
+        && as_vector(update.ask_price_bands()) == (price_bands.empty() ? std::vector<double>() : extended_book::price_band(ask, price_bands));
+}
+
+}   // namespace
+
+
+TEST(Analytics, SameParametersShareOneComputation) {
+    aggregator_server server(port, test_symbols());
+    std::vector<double> volume_bands = {1e5, 1e6, 1e7};
+    std::vector<int> price_bands = {0, 50, 100};
+
+    std::vector<std::unique_ptr<analytics_client>> clients;
+    for (int i = 0; i < 100; ++i)
+        clients.push_back(std::make_unique<analytics_client>(port, make_request(volume_bands, {})));
+    clients.push_back(std::make_unique<analytics_client>(port, make_request({}, price_bands)));
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (server.analytics_clients() < clients.size() && std::chrono::steady_clock::now() < deadline)
+        server.poll_non_block();
+    ASSERT_EQ(server.analytics_clients(), clients.size());
+    ASSERT_EQ(server.analytics_views(), 2u);
+
+    std::mt19937 rng(12);
+    extended_book reference;
+    const int batches = 100;
+    for (int i = 0; i < batches; ++i) {
+        auto ticks = make_batch(rng, 1 + i % 2, i + 1, 20);
+        reference.update_ticks(ticks);
+        server.process_tick(0, ticks);
+        server.poll_non_block();
+    }
+    // one computation per view and batch, not per client
+    EXPECT_EQ(server.analytics_computations(), 2u * batches);
+
+    auto done = [&] {
+        for (size_t i = 0; i < clients.size(); ++i) {
+            bool bands = i < 100;
+            if (!same_figures(clients[i]->last(), reference, bands ? volume_bands : std::vector<double>(),
+                    bands ? std::vector<int>() : price_bands))
+                return false;
+        }
+        return true;
+    };
+    deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!done() && std::chrono::steady_clock::now() < deadline) {
+        server.poll_non_block();
+        for (auto& client : clients)
+            client->poll();
+    }
+    EXPECT_TRUE(done());
+    EXPECT_EQ(clients[0]->last().symbol(), "BTCUSDT");
+}
+
+// A batch that moves no figure of the view sends nothing.
+TEST(Analytics, UnchangedFiguresAreNotSent) {
+    auto level = [] (batched_tick_update& ticks, side_t side, double price, double qty) {
+        auto& tick = *ticks.add_updates();
+        tick.set_side((uint32_t) side);
+        tick.set_price(price);
+        tick.set_quantity(qty);
+    };
+    consolidated_books::symbol_book book;
+    analytics_view view(0, make_request({}, {0, 50}));
+
+    batched_tick_update ticks;
+    ticks.set_exchange(1);
+    level(ticks, side_t::bid, 100000, 1);
+    level(ticks, side_t::ask, 100010, 1);
+    book.book.update_ticks(ticks);
+    ASSERT_TRUE(view.update(book, 1));
+    EXPECT_EQ(view.last().best_bid(), 100000);
+    EXPECT_EQ(view.last().bid_price_bands_size(), 2);
+
+    // a level behind the best ones
+    ticks.clear_updates();
+    level(ticks, side_t::bid, 99000, 3);
+    book.book.update_ticks(ticks);
+    EXPECT_FALSE(view.update(book, 2));
+    EXPECT_EQ(view.last().tick_id(), 1);
+
+    ticks.clear_updates();
+    level(ticks, side_t::bid, 100000, 2);
+    book.book.update_ticks(ticks);
+    ASSERT_TRUE(view.update(book, 3));
+    EXPECT_EQ(view.last().tick_id(), 3);
+    EXPECT_EQ(view.last().best_bid_quantity(), 2);
+    EXPECT_EQ(view.last().symbol(), "BTCUSDT");
+    EXPECT_EQ(view.computations(), 3u);
+}
+
+TEST(Analytics, NeedsSymbol) {
+    aggregator_server server(port, test_symbols());
+    analytics_client client(port, analytics_request());
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (client.poll() && std::chrono::steady_clock::now() < deadline)
+        server.poll_non_block();
+    EXPECT_EQ(client.status().error_code(), grpc::StatusCode::INVALID_ARGUMENT);
+    EXPECT_EQ(server.analytics_views(), 0u);
+}
@@ -0,0 +1,366 @@
+#include <gtest/gtest.h>
+
+#include <map>
+
+#include "stream_test_util.h"
+#include "../client/base_client.h"
+
+
+using namespace stream_test;
+
+namespace {
+
+const uint16_t port = 50181;
+
+// keeps what each subscription got, without the updates, and the book of all
+class recording_client : public base_client<recording_client> {
+public:
+    explicit recording_client(const std::string& connection_str) : base_client<recording_client>(connection_str) {}
+
+    void process_ticks(const batched_tick_update& ticks) {
+        auto& received = received_[current_subscription()];
+        received.push_back(ticks);
+        received.back().clear_updates();
+        updates_ += ticks.updates_size();
+        book_.update_ticks(ticks);
+    }
+
+    void process_reset() {
+        ++resets_;
+        book_ = extended_book();
+    }
+
+    const std::vector<batched_tick_update>& received(subscription_id id) { return received_[id]; }
+    size_t updates() const { return updates_; }
+    int resets() const { return resets_; }
+    const extended_book& book() const { return book_; }
+
+private:
+    std::map<subscription_id, std::vector<batched_tick_update>> received_;
+    size_t updates_ = 0;
+    int resets_ = 0;
+    extended_book book_;
+};
+
+symbol_registry& two_symbols() {
+    symbol_registry& symbols = test_symbols();
+    symbols.intern("ETHUSDT");
+    return symbols;
+}
+
+void wait_streams(aggregator_server& server, size_t streams) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (server.streams() < streams && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ASSERT_EQ(server.streams(), streams);
+}
+
+void publish(aggregator_server& server, std::mt19937& rng, int64_t& tick_id, int n, int levels = 20) {
+    for (int i = 0; i < n; ++i)
+        server.process_tick(0, make_batch(rng, 1 + i % 2, ++tick_id, levels));
+}
+
+// polls until the subscription has read count batches
+void read(recording_client& client, base_client<recording_client>::subscription_id id, size_t count) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (client.received(id).size() < count && std::chrono::steady_clock::now() < deadline)
+        client.poll(std::chrono::system_clock::now() + std::chrono::milliseconds(10));
+    ASSERT_EQ(client.received(id).size(), count);
+}
+
+}   // namespace
+
+
+// Two subscriptions on one client, one completion queue: each batch reaches
+// process_ticks once per subscription asking for its symbol, tagged with it.
+TEST(BaseClient, MultiplexesSubscriptions) {
+    // a queue thread of its own: subscribe() asks ListSymbols synchronously
+    aggregator_server server(port, two_symbols(), {}, 1);
+    recording_client client(absl::StrFormat("localhost:%d", port));
+    auto btc = client.subscribe_symbol("BTCUSDT");
+    auto both = client.subscribe({"BTCUSDT", "ETHUSDT"}, false, 0, agg_proto::encoding_delta);
+    EXPECT_NE(btc, both);
+    EXPECT_EQ(client.subscriptions(), 2u);
+    wait_streams(server, 2);
+
+    std::mt19937 rng(47);
+    int64_t tick_id = 0;
+    for (int i = 0; i < 100; ++i) {
+        auto ticks = make_batch(rng, 1 + i % 2, ++tick_id, 20);
+        symbol_id_t symbol = i % 4 < 2 ? 0 : 1;
+        ticks.set_symbol_id(symbol);
+        server.process_tick(symbol, ticks);
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while ((client.received(btc).size() < 50 || client.received(both).size() < 100) &&
+           std::chrono::steady_clock::now() < deadline)
+        client.poll(std::chrono::system_clock::now() + std::chrono::milliseconds(10));
+    ASSERT_EQ(client.received(btc).size(), 50u);
+    ASSERT_EQ(client.received(both).size(), 100u);
+    EXPECT_EQ(client.updates(), 150u * 20);
+
+    for (const auto& ticks : client.received(btc))
+        EXPECT_EQ(ticks.symbol_id(), 0u);
+    size_t eth = 0;
+    for (const auto& ticks : client.received(both))
+        eth += ticks.symbol_id() == 1;
+    EXPECT_EQ(eth, 50u);
+    // numbered per stream
+    EXPECT_EQ(client.received(btc).back().sequence(), 50u);
+    EXPECT_EQ(client.received(both).back().sequence(), 100u);
+    EXPECT_EQ(client.gaps(), 0u);
+    EXPECT_GT(client.published(both), client.published(btc));
+    EXPECT_FALSE(client.poll_non_block());
+}
+
+// poll() is false once the server has ended every stream
+TEST(BaseClient, EndsWithItsStreams) {
+    auto server = std::make_unique<aggregator_server>(port, two_symbols(), client_queue_config{}, 1);
+    recording_client client(absl::StrFormat("localhost:%d", port));
+    client.subscribe_symbol("BTCUSDT");
+    client.subscribe_symbol("ETHUSDT");
+    wait_streams(*server, 2);
+    server.reset();
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (client.subscriptions() > 0 && std::chrono::steady_clock::now() < deadline)
+        client.poll(std::chrono::system_clock::now() + std::chrono::milliseconds(10));
+    EXPECT_EQ(client.subscriptions(), 0u);
+    EXPECT_FALSE(client.poll());
+}
+
+// Cut off as too slow, the stream is subscribed again from the last batch
+// read and the replay ring fills in what it missed: no batch lost, no reset.
+TEST(BaseClient, ReconnectsAndResumes) {
+    client_queue_config config;
+    config.max_depth = 16;
+    config.policy = slow_client_policy::disconnect;
+    aggregator_server_config server_config;
+    server_config.replay.max_bytes = 64 << 20;
+    aggregator_server server(port, two_symbols(), config, 1, server_config);
+
+    recording_client client(absl::StrFormat("localhost:%d", port));
+    client.set_reconnect({10, 100});
+    auto id = client.subscribe_symbol("BTCUSDT");
+    wait_streams(server, 1);
+    std::mt19937 rng(48);
+    int64_t tick_id = 0;
+    publish(server, rng, tick_id, 10);
+    read(client, id, 10);
+    EXPECT_EQ(client.published(id), 10u);
+
+    // not read meanwhile: more than the flow control window and the queue hold
+    publish(server, rng, tick_id, 200, 200);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (client.published(id) != 210 && std::chrono::steady_clock::now() < deadline)
+        client.poll(std::chrono::system_clock::now() + std::chrono::milliseconds(10));
+    ASSERT_EQ(client.published(id), 210u);
+
+    // a replay longer than the queue is cut off again, from further on
+    EXPECT_GE(client.recovery().reconnects, 1u);
+    EXPECT_EQ(client.recovery().resumed, client.recovery().reconnects);
+    EXPECT_EQ(client.recovery().snapshots, 0u);
+    EXPECT_GT(client.recovery().last_recovery_ns, 0);
+    EXPECT_EQ(client.resets(), 0);
+    uint64_t expected = 0;
+    for (const auto& ticks : client.received(id))
+        EXPECT_EQ(ticks.publish_sequence(), ++expected);
+}
+
+// The publish sequence counts the batches of every symbol: the first batch
+// replayed to a stream of one symbol is past the one after the last it read,
+// and still resumes it.
+TEST(BaseClient, ResumesOneSymbolOfSeveral) {
+    client_queue_config config;
+    config.max_depth = 16;
+    config.policy = slow_client_policy::disconnect;
+    aggregator_server_config server_config;
+    server_config.replay.max_bytes = 64 << 20;
+    aggregator_server server(port, two_symbols(), config, 1, server_config);
+
+    recording_client client(absl::StrFormat("localhost:%d", port));
+    client.set_reconnect({10, 100});
+    auto id = client.subscribe_symbol("BTCUSDT");
+    wait_streams(server, 1);
+    std::mt19937 rng(52);
+    extended_book reference;
+    int64_t tick_id = 0;
+    // BTCUSDT, ETHUSDT in turn
+    auto publish_both = [&] (int n, int levels) {
+        for (int i = 0; i < n; ++i) {
+            symbol_id_t symbol = i % 2;
+            auto ticks = make_batch(rng, 1 + i / 2 % 2, ++tick_id, levels);
+            ticks.set_symbol_id(symbol);
+            if (symbol == 0)
+                reference.update_ticks(ticks);
+            server.process_tick(symbol, ticks);
+        }
+    };
+    publish_both(20, 20);
+    read(client, id, 10);
+    EXPECT_EQ(client.published(id), 19u);
+
+    // not read meanwhile: more than the flow control window and the queue hold
+    publish_both(400, 200);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (client.published(id) != 419 && std::chrono::steady_clock::now() < deadline)
+        client.poll(std::chrono::system_clock::now() + std::chrono::milliseconds(10));
+    ASSERT_EQ(client.published(id), 419u);
+
+    EXPECT_GE(client.recovery().reconnects, 1u);
+    EXPECT_EQ(client.recovery().resumed, client.recovery().reconnects);
+    EXPECT_EQ(client.recovery().snapshots, 0u);
+    EXPECT_EQ(client.resets(), 0);
+    ASSERT_EQ(client.received(id).size(), 210u);
+    expect_same_levels(client.book(), reference);
+}
+
+// A server restarted has none of the batches the client read: the stream
+// comes back after the backoff from a snapshot, and the client is told to
+// drop its book first.
+TEST(BaseClient, ReconnectsToARestartedServer) {
+    auto server = std::make_unique<aggregator_server>(port, two_symbols(), client_queue_config{}, 1);
+    recording_client client(absl::StrFormat("localhost:%d", port));
+    client.set_reconnect({10, 100});
+    auto id = client.subscribe_symbol("BTCUSDT");
+    wait_streams(*server, 1);
+    std::mt19937 rng(49);
+    int64_t tick_id = 0;
+    publish(*server, rng, tick_id, 10);
+    read(client, id, 10);
+
+    server.reset();
+    // the stream ends, the first attempts find no server
+    auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+    while (std::chrono::steady_clock::now() < until)
+        client.poll(std::chrono::system_clock::now() + std::chrono::milliseconds(10));
+    EXPECT_EQ(client.subscriptions(), 1u);
+
+    server = std::make_unique<aggregator_server>(port, two_symbols(), client_queue_config{}, 1);
+    // the client subscribes again as it polls
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (server->streams() < 1 && std::chrono::steady_clock::now() < deadline)
+        client.poll(std::chrono::system_clock::now() + std::chrono::milliseconds(10));
+    ASSERT_EQ(server->streams(), 1u);
+    publish(*server, rng, tick_id, 10);
+    read(client, id, 20);
+    EXPECT_EQ(client.resets(), 1);
+    EXPECT_GE(client.recovery().reconnects, 2u);
+    EXPECT_EQ(client.recovery().snapshots, 1u);
+    EXPECT_EQ(client.recovery().resumed, 0u);
+    EXPECT_GE(client.recovery().last_recovery_ns, 200'000'000);
+    // a new stream, numbered from 1
+    EXPECT_EQ(client.received(id).back().sequence(), 10u);
+}
+
+// A server restarted numbers its batches from 1 again: once it has published
+// past the batch the client resumes from, the sequence alone would have it
+// replay its own batches onto the old book. Its epoch differs, the client
+// gets a snapshot and is told to drop its book first.
+TEST(BaseClient, DoesNotResumeFromAnotherEpoch) {
+    aggregator_server_config server_config;
+    server_config.replay.max_bytes = 64 << 20;
+    auto server = std::make_unique<aggregator_server>(port, two_symbols(), client_queue_config{}, 1, server_config);
+    recording_client client(absl::StrFormat("localhost:%d", port));
+    client.set_reconnect({10, 100});
+    auto id = client.subscribe_symbol("BTCUSDT");
+    wait_streams(*server, 1);
+    std::mt19937 rng(51);
+    int64_t tick_id = 0;
+    publish(*server, rng, tick_id, 10);
+    read(client, id, 10);
+    ASSERT_EQ(client.published(id), 10u);
+
+    // the new server is at 15 before the client is back
+    server.reset();
+    server = std::make_unique<aggregator_server>(port, two_symbols(), client_queue_config{}, 1, server_config);
+    publish(*server, rng, tick_id, 15);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (client.recovery().snapshots + client.recovery().resumed == 0 && std::chrono::steady_clock::now() < deadline)
+        client.poll(std::chrono::system_clock::now() + std::chrono::milliseconds(10));
+    EXPECT_EQ(client.recovery().resumed, 0u);
+    EXPECT_EQ(client.recovery().snapshots, 1u);
+    EXPECT_EQ(client.resets(), 1);
+    ASSERT_GT(client.received(id).size(), 10u);
+    EXPECT_EQ(client.received(id)[10].flag(), (uint64_t) updata_flag_t::snapshot);
+    EXPECT_EQ(client.received(id)[10].publish_sequence(), 15u);
+    EXPECT_NE(client.received(id)[10].publish_epoch(), client.received(id)[9].publish_epoch());
+}
+
+// A server restarted under another configuration has other ids: the client
+// lists the names again and gets the symbol it subscribed to.
+TEST(BaseClient, ResolvesTheSymbolsAgainAfterARestart) {
+    auto server = std::make_unique<aggregator_server>(port, two_symbols(), client_queue_config{}, 1);
+    recording_client client(absl::StrFormat("localhost:%d", port));
+    client.set_reconnect({10, 100});
+    auto id = client.subscribe_symbol("BTCUSDT");
+    wait_streams(*server, 1);
+    std::mt19937 rng(53);
+    int64_t tick_id = 0;
+    publish(*server, rng, tick_id, 10);
+    read(client, id, 10);
+
+    static symbol_registry swapped;
+    swapped.intern("ETHUSDT");
+    swapped.intern("BTCUSDT");
+    server.reset();
+    server = std::make_unique<aggregator_server>(port, swapped, client_queue_config{}, 1);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (server->streams() < 1 && std::chrono::steady_clock::now() < deadline)
+        client.poll(std::chrono::system_clock::now() + std::chrono::milliseconds(10));
+    ASSERT_EQ(server->streams(), 1u);
+
+    for (int i = 0; i < 20; ++i) {
+        symbol_id_t symbol = i % 2;
+        auto ticks = make_batch(rng, 1, ++tick_id, 20);
+        ticks.set_symbol_id(symbol);
+        server->process_tick(symbol, ticks);
+    }
+    read(client, id, 20);
+    for (size_t i = 10; i < client.received(id).size(); ++i)
+        EXPECT_EQ(client.received(id)[i].symbol_id(), 1u);
+    ASSERT_NE(client.symbol(1), nullptr);
+    EXPECT_EQ(client.symbol(1)->name(), "BTCUSDT");
+    EXPECT_EQ(client.symbol(0), nullptr);
+}
+
+// Batches dropped for a client too slow leave a gap in the stream: the
+// client starts over from a snapshot and ends with the book of the server.
+TEST(BaseClient, StartsOverAfterAGap) {
+    client_queue_config config;
+    config.max_depth = 16;
+    config.policy = slow_client_policy::drop_oldest;
+    aggregator_server server(port, two_symbols(), config, 1);
+    recording_client client(absl::StrFormat("localhost:%d", port));
+    auto id = client.subscribe_symbol("BTCUSDT");
+    wait_streams(server, 1);
+
+    // not read meanwhile: more than the flow control window and the queue hold
+    std::mt19937 rng(50);
+    extended_book reference;
+    int64_t tick_id = 0;
+    for (int i = 0; i < 200; ++i) {
+        auto ticks = make_batch(rng, 1 + i % 2, ++tick_id, 200);
+        reference.update_ticks(ticks);
+        server.process_tick(0, ticks);
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (client.published(id) != 200 && std::chrono::steady_clock::now() < deadline)
+        client.poll(std::chrono::system_clock::now() + std::chrono::milliseconds(10));
+    ASSERT_EQ(client.published(id), 200u);
+    // the rest of the snapshot
+    auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+    while (std::chrono::steady_clock::now() < until)
+        client.poll(std::chrono::system_clock::now() + std::chrono::milliseconds(10));
+
+    EXPECT_GE(client.gaps(), 1u);
+    EXPECT_GE(client.resets(), 1);
+    EXPECT_EQ(client.recovery().snapshots, client.gaps());
+    // the new stream, numbered from 1
+    EXPECT_EQ(client.received(id).back().flag(), (uint64_t) updata_flag_t::snapshot);
+    EXPECT_EQ(client.received(id).back().sequence(), 2u);
+    expect_same_levels(client.book(), reference);
+}
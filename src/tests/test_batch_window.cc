@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include "stream_test_util.h"
+
+
+using namespace stream_test;
+
+namespace {
+
+const uint16_t port = 50168;
+const int64_t us = 1000;
+
+struct collector {
+    void operator()(symbol_id_t symbol, const batched_tick_update& ticks) {
+        symbols.push_back(symbol);
+        batches.push_back(ticks);
+    }
+    std::vector<symbol_id_t> symbols;
+    std::vector<batched_tick_update> batches;
+};
+
+}   // namespace
+
+
+TEST(BatchWindow, MergesExchangesWithinWindow) {
+    batch_window_config config;
+    config.window_us = 100;
+    batch_window window(config);
+    collector out;
+    std::mt19937 rng(40);
+
+    window.add(0, make_batch(rng, 1, 1, 4), 0, out);
+    window.add(0, make_batch(rng, 2, 2, 6), 10 * us, out);
+    window.add(1, make_batch(rng, 1, 3, 2), 50 * us, out);
+    window.poll(99 * us, out);
+    EXPECT_TRUE(out.batches.empty());
+
+    window.poll(100 * us, out);
+    ASSERT_EQ(out.batches.size(), 1u);
+    const auto& merged = out.batches[0];
+    EXPECT_EQ(out.symbols[0], 0u);
+    EXPECT_EQ(merged.exchange(), (uint32_t) exchange_t::undefined);
+    EXPECT_EQ(merged.tick_id(), 2);
+    ASSERT_EQ(merged.updates_size(), 10);
+    for (int i = 0; i < merged.updates_size(); ++i)
+        EXPECT_EQ(merged.updates(i).exchange(), i < 4 ? 1u : 2u);
+
+    // one exchange only in the window: a batch of that exchange
+    window.poll(150 * us, out);
+    ASSERT_EQ(out.batches.size(), 2u);
+    EXPECT_EQ(out.symbols[1], 1u);
+    EXPECT_EQ(out.batches[1].exchange(), 1u);
+    EXPECT_EQ(out.batches[1].updates(0).exchange(), 0u);
+
+    EXPECT_EQ(window.stats().batches_in, 3u);
+    EXPECT_EQ(window.stats().batches_out, 2u);
+    EXPECT_EQ(window.stats().merged, 1u);
+}
+
+TEST(BatchWindow, FlushesOnSizeAndSnapshot) {
+    batch_window_config config;
+    config.window_us = 1000;
+    config.max_updates = 10;
+    batch_window window(config);
+    collector out;
+    std::mt19937 rng(41);
+
+    window.add(0, make_batch(rng, 1, 1, 6), 0, out);
+    EXPECT_TRUE(out.batches.empty());
+    window.add(0, make_batch(rng, 2, 2, 6), 0, out);
+    ASSERT_EQ(out.batches.size(), 1u);
+    EXPECT_EQ(out.batches[0].updates_size(), 12);
+
+    // the snapshot publishes what is pending first, then goes out unmerged
+    window.add(0, make_batch(rng, 1, 3, 2), 0, out);
+    auto snapshot = make_batch(rng, 2, 4, 2);
+    snapshot.set_flag((uint64_t) updata_flag_t::snapshot);
+    window.add(0, snapshot, 0, out);
+    ASSERT_EQ(out.batches.size(), 3u);
+    EXPECT_EQ(out.batches[1].exchange(), 1u);
+    EXPECT_EQ(out.batches[2].exchange(), 2u);
+    EXPECT_EQ(out.batches[2].flag(), (uint64_t) updata_flag_t::snapshot);
+
+    // the window that was open is gone
+    window.poll(2000 * us, out);
+    EXPECT_EQ(out.batches.size(), 3u);
+}
+
+TEST(BatchWindow, StreamsMatchReference) {
+    aggregator_server_config server_config;
+    server_config.batch_window.window_us = 200;
+    aggregator_server server(port, test_symbols(), {}, 0, server_config);
+    const batch_window_config& config = server_config.batch_window;
+
+    tick_request exchange_only;
+    exchange_only.set_symbol("BTCUSDT");
+    exchange_only.add_exchanges(2);
+    stream_client all(port);
+    stream_client filtered(port, exchange_only);
+    wait_connected(server, 2);
+
+    std::mt19937 rng(42);
+    extended_book reference;
+    extended_book reference_2;
+    int64_t tick_id = 0;
+    for (int i = 0; i < 400; ++i) {
+        auto ticks = make_batch(rng, 1 + i % 2, ++tick_id, 20);
+        reference.update_ticks(ticks);
+        if (ticks.exchange() == 2)
+            reference_2.update_ticks(ticks);
+        server.process_tick(0, ticks);
+        server.poll_batch_window();
+        server.poll_non_block();
+        if (i % 8 == 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(config.window_us));
+    server.poll_batch_window();
+    EXPECT_GT(server.window_stats().merged, 0u);
+    EXPECT_LT(server.window_stats().batches_out, server.window_stats().batches_in);
+
+    extended_book book;
+    extended_book book_2;
+    batched_tick_update last;
+    batched_tick_update last_2;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while ((last.tick_id() != tick_id || last_2.tick_id() != tick_id) && std::chrono::steady_clock::now() < deadline) {
+        server.poll_non_block();
+        all.poll(book, last);
+        filtered.poll(book_2, last_2);
+    }
+    ASSERT_EQ(last.tick_id(), tick_id);
+    ASSERT_EQ(last_2.tick_id(), tick_id);
+    expect_same_levels(book, reference);
+    expect_same_levels(book_2, reference_2);
+
+    // the filtered stream never sees another exchange
+    for (const auto& ticks : filtered.received())
+        EXPECT_EQ(ticks.exchange(), 2u);
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include "../binlog.h"
+#include "../binlog_decoder.h"
+
+
+namespace {
+
+std::string read_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+template <typename T>
+void put(std::string& out, T v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+void put_str(std::string& out, const std::string& s) {
+    put<uint16_t>(out, (uint16_t) s.size());
+    out += s;
+}
+
+void put_record(std::string& out, uint32_t id, const std::string& body) {
+    put<uint32_t>(out, id);
+    put<uint32_t>(out, (uint32_t) body.size());
+    out += body;
+}
+
+// a log with site 0, "{} and {}" of a u64 and a blob
+std::string site_log() {
+    std::string log(binlog::magic, sizeof(binlog::magic));
+    std::string def;
+    put<uint32_t>(def, 7);
+    put_str(def, "f.cc");
+    put_str(def, "{} and {}");
+    put<uint8_t>(def, 2);
+    put<uint8_t>(def, (uint8_t) binlog::arg_type::u64);
+    put<uint8_t>(def, (uint8_t) binlog::arg_type::blob);
+    put_record(log, binlog::def_flag, def);
+    return log;
+}
+
+}   // namespace
+
+
+// What BINLOG writes, logdecode renders.
+TEST(Binlog, RoundTrip) {
+    std::string name = "/tmp/test_binlog_" + std::to_string(getpid());
+    {
+        auto writer = binlog::make_writer(name, true);
+        const char frame[] = {'o', 'k', '\x01'};
+        BINLOG("received {} bytes from exchange {}", 42, 2u);
+        BINLOG("price {} frame {}", -0.5, binlog::blob{frame, sizeof(frame)});
+        std::thread([] { BINLOG("from another thread {}", (int64_t) -7); }).join();
+    }
+    std::string data = read_file(name + ".binlog");
+    unlink((name + ".binlog").c_str());
+
+    std::ostringstream out;
+    std::string error;
+    ASSERT_TRUE(binlog::decode(data, out, error)) << error;
+    std::string text = out.str();
+    EXPECT_NE(text.find("[INFO] "), std::string::npos);
+    EXPECT_NE(text.find("test_binlog.cc:"), std::string::npos);
+    EXPECT_NE(text.find(" received 42 bytes from exchange 2\n"), std::string::npos) << text;
+    EXPECT_NE(text.find(" price -0.5 frame ok\\x01\n"), std::string::npos) << text;
+    EXPECT_NE(text.find(" from another thread -7\n"), std::string::npos) << text;
+
+    // cut anywhere: the lines before the cut, never a read past it
+    for (size_t size = 0; size < data.size(); ++size) {
+        std::ostringstream partial;
+        binlog::decode(data.substr(0, size), partial, error);
+        EXPECT_EQ(text.compare(0, partial.str().size(), partial.str()), 0);
+    }
+}
+
+TEST(Binlog, CorruptRecordsAreReported) {
+    std::ostringstream out;
+    std::string error;
+    EXPECT_FALSE(binlog::decode("BINLOG02", out, error));
+    EXPECT_EQ(error, "not a binary log");
+
+    // an event whose blob is longer than its record
+    std::string log = site_log();
+    std::string event;
+    put<int64_t>(event, 1'700'000'000'000'000'000);
+    put<uint64_t>(event, 5);
+    put<uint32_t>(event, 100);
+    event += "abc";
+    put_record(log, 0, event);
+    EXPECT_FALSE(binlog::decode(log, out, error));
+    EXPECT_EQ(error, "corrupt event of site 0");
+
+    // a record longer than the file
+    log = site_log();
+    put<uint32_t>(log, 0);
+    put<uint32_t>(log, 1000);
+    EXPECT_FALSE(binlog::decode(log, out, error));
+    EXPECT_EQ(error, "truncated record");
+
+    // a definition with more argument types than its record holds
+    log = std::string(binlog::magic, sizeof(binlog::magic));
+    std::string def;
+    put<uint32_t>(def, 1);
+    put_str(def, "f.cc");
+    put_str(def, "{}");
+    put<uint8_t>(def, 3);
+    put<uint8_t>(def, (uint8_t) binlog::arg_type::i64);
+    put_record(log, binlog::def_flag | 1, def);
+    EXPECT_FALSE(binlog::decode(log, out, error));
+    EXPECT_EQ(error, "corrupt definition of site 1");
+
+    // and the well formed one decodes
+    log = site_log();
+    event.clear();
+    put<int64_t>(event, 1'700'000'000'000'000'000);
+    put<uint64_t>(event, 5);
+    put<uint32_t>(event, 3);
+    event += "abc";
+    put_record(log, 0, event);
+    std::ostringstream good;
+    ASSERT_TRUE(binlog::decode(log, good, error)) << error;
+    EXPECT_EQ(good.str(), "2023-11-14T22:13:20.000000000Z [INFO] f.cc:7 5 and abc\n");
+}
+
+// An event its thread buffer cannot hold is counted, and the count goes in the log.
+TEST(Binlog, DroppedEventsAreLogged) {
+    std::string name = "/tmp/test_binlog_dropped_" + std::to_string(getpid());
+    {
+        auto writer = binlog::make_writer(name, true);
+        std::string frame(2 << 20, 'x');
+        BINLOG("frame {}", binlog::blob{frame.data(), (uint32_t) frame.size()});
+        BINLOG("after the frame {}", 1u);
+    }
+    std::string data = read_file(name + ".binlog");
+    unlink((name + ".binlog").c_str());
+
+    std::ostringstream out;
+    std::string error;
+    ASSERT_TRUE(binlog::decode(data, out, error)) << error;
+    std::string text = out.str();
+    EXPECT_NE(text.find(" [WARNING] binlog: dropped 1 events\n"), std::string::npos) << text;
+    EXPECT_NE(text.find(" after the frame 1\n"), std::string::npos) << text;
+    EXPECT_EQ(text.find(" frame x"), std::string::npos);
+
+    // a lost record cut short
+    std::string log = site_log();
+    std::string lost;
+    put<int64_t>(lost, 1'700'000'000'000'000'000);
+    put_record(log, binlog::lost_id, lost);
+    EXPECT_FALSE(binlog::decode(log, out, error));
+    EXPECT_EQ(error, "corrupt record of events lost");
+}
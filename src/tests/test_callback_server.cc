@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include "stream_test_util.h"
+#include "../server/callback_server.h"
+
+
+using namespace stream_test;
+
+namespace {
+
+const uint16_t port = 50167;
+
+void wait_streams(callback_server& server, size_t streams) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (server.streams() < streams && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ASSERT_EQ(server.streams(), streams);
+}
+
+void publish(callback_server& server, extended_book& reference, std::mt19937& rng, int64_t& tick_id, int n) {
+    for (int i = 0; i < n; ++i) {
+        auto ticks = make_batch(rng, 1 + i % 2, ++tick_id, 200);
+        reference.update_ticks(ticks);
+        server.process_tick(0, ticks);
+    }
+}
+
+}   // namespace
+
+
+TEST(CallbackServer, StreamsMatchReference) {
+    callback_server server(port, test_symbols());
+    std::vector<std::unique_ptr<stream_client>> clients;
+    for (int i = 0; i < 3; ++i)
+        clients.push_back(std::make_unique<stream_client>(port));
+    wait_streams(server, clients.size());
+
+    std::mt19937 rng(14);
+    extended_book reference;
+    int64_t tick_id = 0;
+    publish(server, reference, rng, tick_id, 100);
+    // starts from the snapshot
+    clients.push_back(std::make_unique<stream_client>(port));
+    wait_streams(server, clients.size());
+    publish(server, reference, rng, tick_id, 100);
+
+    std::vector<extended_book> books(clients.size());
+    std::vector<batched_tick_update> last(clients.size());
+    auto done = [&] {
+        for (const auto& ticks : last)
+            if (ticks.tick_id() != tick_id) return false;
+        return true;
+    };
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!done() && std::chrono::steady_clock::now() < deadline)
+        for (size_t i = 0; i < clients.size(); ++i)
+            clients[i]->poll(books[i], last[i]);
+    ASSERT_TRUE(done());
+    for (auto& book : books)
+        expect_same_levels(book, reference);
+    EXPECT_EQ(clients.back()->received()[0].flag(), (uint64_t) updata_flag_t::snapshot);
+}
+
+TEST(CallbackServer, Disconnect_FinishesStream) {
+    client_queue_config config;
+    config.max_depth = 16;
+    config.policy = slow_client_policy::disconnect;
+    callback_server server(port, test_symbols(), config);
+    stream_client client(port);
+    wait_streams(server, 1);
+
+    std::mt19937 rng(15);
+    extended_book reference;
+    int64_t tick_id = 0;
+    publish(server, reference, rng, tick_id, 2000);
+    EXPECT_EQ(server.streams(), 0u);
+
+    extended_book book;
+    batched_tick_update last;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (client.poll(book, last) && std::chrono::steady_clock::now() < deadline) {}
+    EXPECT_EQ(client.status().error_code(), grpc::StatusCode::RESOURCE_EXHAUSTED);
+}
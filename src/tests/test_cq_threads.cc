@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include "stream_test_util.h"
+
+
+using namespace stream_test;
+
+namespace {
+
+const uint16_t port = 50166;
+
+void wait_streams(aggregator_server& server, size_t streams) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (server.streams() < streams && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ASSERT_EQ(server.streams(), streams);
+}
+
+}   // namespace
+
+
+// Every queue thread sees every batch: wherever gRPC put a stream, it ends
+// with the publisher's book, late subscribers included.
+TEST(CqThreads, EveryQueueSeesEveryBatch) {
+    // a ring smaller than what is published: the publisher waits for the queue threads
+    aggregator_server_config server_config;
+    server_config.ring_size = 16;
+    aggregator_server server(port, test_symbols(), {}, 3, server_config);
+    EXPECT_EQ(server.queues(), 3u);
+    std::vector<std::unique_ptr<stream_client>> clients;
+    for (int i = 0; i < 6; ++i)
+        clients.push_back(std::make_unique<stream_client>(port));
+    wait_streams(server, clients.size());
+
+    std::mt19937 rng(13);
+    extended_book reference;
+    int64_t tick_id = 0;
+    auto publish = [&] (int n) {
+        for (int i = 0; i < n; ++i) {
+            auto ticks = make_batch(rng, 1 + i % 2, ++tick_id, 20);
+            reference.update_ticks(ticks);
+            server.process_tick(0, ticks);
+        }
+    };
+    publish(100);
+    // from the snapshot of its own queue
+    clients.push_back(std::make_unique<stream_client>(port));
+    wait_streams(server, clients.size());
+    publish(100);
+
+    std::vector<extended_book> books(clients.size());
+    std::vector<batched_tick_update> last(clients.size());
+    auto done = [&] {
+        for (const auto& ticks : last)
+            if (ticks.tick_id() != tick_id) return false;
+        return true;
+    };
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!done() && std::chrono::steady_clock::now() < deadline)
+        for (size_t i = 0; i < clients.size(); ++i)
+            clients[i]->poll(books[i], last[i]);
+    ASSERT_TRUE(done());
+    for (size_t i = 0; i < clients.size(); ++i)
+        expect_same_levels(books[i], reference);
+    EXPECT_EQ(clients.back()->received()[0].flag(), (uint64_t) updata_flag_t::snapshot);
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include "stream_test_util.h"
+
+
+using namespace stream_test;
+using order_book::tick_data;
+
+namespace {
+
+const uint16_t port = 50164;
+
+tick_request depth_request(uint32_t depth) {
+    tick_request request;
+    request.set_symbol("BTCUSDT");
+    request.set_depth(depth);
+    return request;
+}
+
+std::vector<tick_data> top(const extended_book& book, side_t side, size_t n) {
+    std::vector<tick_data> levels;
+    book.for_each_top(side, n, [&] (int64_t, const tick_data& level) { levels.push_back(level); });
+    return levels;
+}
+
+bool same_top(const extended_book& book, const extended_book& reference, size_t n) {
+    for (side_t side : {side_t::bid, side_t::ask}) {
+        auto a = top(book, side, n);
+        auto b = top(reference, side, n);
+        if (a.size() != b.size())
+            return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (a[i].price != b[i].price)
+                return false;
+            for (uint32_t exchange = 0; exchange < (uint32_t) exchange_t::total; ++exchange)
+                if (std::abs(a[i].qty[exchange] - b[i].qty[exchange]) > 1e-9)
+                    return false;
+        }
+    }
+    return true;
+}
+
+}   // namespace
+
+
+TEST(Depth, TopLevelsMatchReference) {
+    aggregator_server server(port, test_symbols());
+    std::vector<std::unique_ptr<stream_client>> clients;
+    clients.push_back(std::make_unique<stream_client>(port, depth_request(5)));
+    clients.push_back(std::make_unique<stream_client>(port, depth_request(5)));
+    clients.push_back(std::make_unique<stream_client>(port, depth_request(1)));
+    wait_connected(server, clients.size());
+    EXPECT_EQ(server.depth_views(), 2u);
+
+    std::mt19937 rng(11);
+    extended_book reference;
+    int64_t tick_id = 0;
+    publish(server, reference, rng, tick_id, 200);
+
+    // a late subscriber starts from the view snapshot
+    clients.push_back(std::make_unique<stream_client>(port, depth_request(5)));
+    wait_connected(server, clients.size());
+    publish(server, reference, rng, tick_id, 200);
+
+    std::vector<size_t> depths = {5, 5, 1, 5};
+    std::vector<extended_book> books(clients.size());
+    batched_tick_update last;
+    auto done = [&] {
+        for (size_t i = 0; i < clients.size(); ++i)
+            if (!same_top(books[i], reference, depths[i])) return false;
+        return true;
+    };
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!done() && std::chrono::steady_clock::now() < deadline) {
+        server.poll_non_block();
+        for (size_t i = 0; i < clients.size(); ++i)
+            clients[i]->poll(books[i], last);
+    }
+    for (size_t i = 0; i < clients.size(); ++i) {
+        EXPECT_TRUE(same_top(books[i], reference, depths[i])) << "client " << i;
+        // levels pushed out of the top were removed
+        EXPECT_EQ(top(books[i], side_t::bid, 100).size(), depths[i]) << "client " << i;
+        for (const auto& ticks : clients[i]->received())
+            EXPECT_EQ(ticks.exchange(), (uint32_t) exchange_t::undefined);
+    }
+    EXPECT_EQ(clients[3]->received()[0].flag(), (uint64_t) updata_flag_t::snapshot);
+}
+
+TEST(Depth, NeedsSymbol) {
+    aggregator_server server(port, test_symbols());
+    tick_request request;
+    request.set_depth(5);
+    stream_client client(port, request);
+
+    extended_book book;
+    batched_tick_update last;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (client.poll(book, last) && std::chrono::steady_clock::now() < deadline)
+        server.poll_non_block();
+    EXPECT_EQ(client.status().error_code(), grpc::StatusCode::INVALID_ARGUMENT);
+    EXPECT_TRUE(server.clients().empty());
+}
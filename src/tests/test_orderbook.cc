@@ -111,6 +111,33 @@ TEST(OrderBook, Aggregation_Ask) {
 
 }
 
+// More levels than the bands need: the bands filled by the first levels, the
+// levels past them not looked at.
+TEST(OrderBook, VolumeBandsShorterThanTheBook) {
+    extended_book book;
+    batched_tick_update ticks;
+    ticks.set_exchange(1);
+    ticks.set_symbol("BTCUSDT");
+    ticks.set_tick_id(0);
+    for (int i = 0; i < 100; ++i) {
+        auto& bid = *ticks.add_updates();
+        bid.set_price(100000 - i);
+        bid.set_quantity(1);
+        bid.set_side((uint8_t) side_t::bid);
+        auto& ask = *ticks.add_updates();
+        ask.set_price(100001 + i);
+        ask.set_quantity(1);
+        ask.set_side((uint8_t) side_t::ask);
+    }
+    book.update_ticks(ticks);
+
+    EXPECT_EQ(book.volume_band_bids({150000}), std::vector<double>({99999}));
+    EXPECT_EQ(book.volume_band_asks({100001, 200000}), std::vector<double>({100001, 100002}));
+    EXPECT_TRUE(book.volume_band_bids({}).empty());
+    // beyond the whole book: not filled
+    EXPECT_EQ(book.volume_band_asks({100001, 1e12}), std::vector<double>({100001, 0}));
+}
+
 
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
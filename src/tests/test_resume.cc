@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+
+#include "stream_test_util.h"
+
+
+using namespace stream_test;
+
+namespace {
+
+const uint16_t port = 50180;
+const int64_t ms = 1'000'000;
+
+// reads until the client has the batches up to tick_id, into book
+void catch_up(aggregator_server& server, stream_client& client, extended_book& book, int64_t tick_id) {
+    batched_tick_update last;
+    int64_t last_tick_id[3] = {};
+    size_t seen = client.received().size();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while ((last_tick_id[1] != tick_id - 1 || last_tick_id[2] != tick_id) && std::chrono::steady_clock::now() < deadline) {
+        server.poll_non_block();
+        client.poll(book, last);
+        for (; seen < client.received().size(); ++seen)
+            last_tick_id[client.received()[seen].exchange()] = client.received()[seen].tick_id();
+    }
+    ASSERT_EQ(last_tick_id[1], tick_id - 1);
+    ASSERT_EQ(last_tick_id[2], tick_id);
+}
+
+tick_request resume_request(uint64_t from, uint64_t epoch) {
+    tick_request request;
+    request.set_symbol("BTCUSDT");
+    request.set_resume_from(from);
+    request.set_resume_epoch(epoch);
+    return request;
+}
+
+}   // namespace
+
+
+TEST(Resume, RingBoundedByBytesAndAge) {
+    std::mt19937 rng(50);
+    auto ticks = make_batch(rng, 1, 1, 20);
+    size_t bytes = ticks.ByteSizeLong();
+
+    replay_config config;
+    config.max_bytes = 10 * bytes;
+    config.max_age_ms = 100;
+    replay_ring ring(config);
+    for (uint64_t i = 1; i <= 20; ++i)
+        ring.add(i, 0, ticks, i * ms);
+    EXPECT_EQ(ring.stats().batches, 10u);
+    EXPECT_TRUE(ring.covers(10, 20, 20 * ms));
+    EXPECT_FALSE(ring.covers(9, 20, 20 * ms));
+    EXPECT_TRUE(ring.covers(20, 20, 20 * ms));
+    // ahead of the server: another server, or one restarted
+    EXPECT_FALSE(ring.covers(21, 20, 20 * ms));
+
+    std::vector<uint64_t> replayed;
+    ring.replay(15, [&] (const replay_ring::entry& e) { replayed.push_back(e.sequence); });
+    EXPECT_EQ(replayed, (std::vector<uint64_t>{16, 17, 18, 19, 20}));
+
+    // older than 100 ms
+    EXPECT_FALSE(ring.covers(15, 20, 117 * ms));
+    EXPECT_EQ(ring.stats().batches, 4u);
+    EXPECT_EQ(ring.stats().hits, 2u);
+    EXPECT_EQ(ring.stats().misses, 3u);
+}
+
+TEST(Resume, ReplaysWhatTheStreamMissed) {
+    aggregator_server_config config;
+    config.replay.max_bytes = 64 << 20;
+    aggregator_server server(port, test_symbols(), {}, 0, config);
+
+    std::mt19937 rng(51);
+    extended_book reference;
+    int64_t tick_id = 0;
+    extended_book book;
+    uint64_t from, epoch;
+    {
+        stream_client client(port);
+        wait_connected(server);
+        publish(server, reference, rng, tick_id, 200);
+        catch_up(server, client, book, tick_id);
+        from = client.received().back().publish_sequence();
+        epoch = client.received().back().publish_epoch();
+        EXPECT_EQ(from, 200u);
+        EXPECT_EQ(epoch, server.publish_epoch());
+    }
+    // published while the client is away
+    publish(server, reference, rng, tick_id, 300);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!server.clients().empty() && std::chrono::steady_clock::now() < deadline)
+        server.poll_non_block();
+
+    stream_client resumed(port, resume_request(from, epoch));
+    wait_connected(server);
+    catch_up(server, resumed, book, tick_id);
+    EXPECT_EQ(server.replay_stats().hits, 1u);
+    EXPECT_EQ(server.replay_stats().replayed, 300u);
+    // no snapshot, the batches from where the first stream stopped
+    ASSERT_EQ(resumed.received().size(), 300u);
+    EXPECT_EQ(resumed.received()[0].flag(), 0u);
+    EXPECT_EQ(resumed.received()[0].publish_sequence(), from + 1);
+    EXPECT_EQ(resumed.received()[0].sequence(), 1u);
+    expect_same_levels(book, reference);
+}
+
+TEST(Resume, SnapshotOnceTheRingHasMovedOn) {
+    std::mt19937 rng(52);
+    aggregator_server_config config;
+    config.replay.max_bytes = 20 * make_batch(rng, 1, 1, 200).ByteSizeLong();
+    aggregator_server server(port, test_symbols(), {}, 0, config);
+
+    extended_book reference;
+    int64_t tick_id = 0;
+    publish(server, reference, rng, tick_id, 100);
+    uint64_t from = 50;
+    publish(server, reference, rng, tick_id, 100);
+
+    stream_client resumed(port, resume_request(from, server.publish_epoch()));
+    wait_connected(server);
+    EXPECT_EQ(server.replay_stats().misses, 1u);
+    expect_same_book(server, resumed, reference, tick_id);
+    EXPECT_EQ(resumed.received()[0].flag(), (uint64_t) updata_flag_t::snapshot);
+    // the snapshot carries the position of the book
+    EXPECT_EQ(resumed.received()[0].publish_sequence(), 200u);
+}
+
+// the ring has the batches, but the position is that of another server
+TEST(Resume, SnapshotFromAnotherEpoch) {
+    aggregator_server_config config;
+    config.replay.max_bytes = 64 << 20;
+    aggregator_server server(port, test_symbols(), {}, 0, config);
+
+    std::mt19937 rng(53);
+    extended_book reference;
+    int64_t tick_id = 0;
+    publish(server, reference, rng, tick_id, 100);
+
+    stream_client resumed(port, resume_request(50, server.publish_epoch() + 1));
+    wait_connected(server);
+    expect_same_book(server, resumed, reference, tick_id);
+    EXPECT_EQ(server.replay_stats().replayed, 0u);
+    EXPECT_EQ(resumed.received()[0].flag(), (uint64_t) updata_flag_t::snapshot);
+    EXPECT_EQ(resumed.received()[0].publish_sequence(), 100u);
+    EXPECT_EQ(resumed.received()[0].publish_epoch(), server.publish_epoch());
+}
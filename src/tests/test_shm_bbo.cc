@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include "stream_test_util.h"
+#include "../shm_bbo.h"
+
+
+using namespace stream_test;
+
+namespace {
+
+const uint16_t port = 50183;
+
+std::string table_name(const char* test) {
+    return "/agg_test_" + std::to_string(getpid()) + "_" + test;
+}
+
+// every field of the quote set to n
+shm_bbo::quote uniform_quote(double n) {
+    shm_bbo::quote q;
+    q.bid.price = q.ask.price = n;
+    std::fill(std::begin(q.bid.qty), std::end(q.bid.qty), n);
+    std::fill(std::begin(q.ask.qty), std::end(q.ask.qty), n);
+    q.tick_id = (int64_t) n;
+    q.publish_sequence = (uint64_t) n;
+    return q;
+}
+
+bool is_uniform(const shm_bbo::quote& q) {
+    double n = q.bid.price;
+    bool uniform = q.ask.price == n && q.tick_id == (int64_t) n && q.publish_sequence == (uint64_t) n;
+    for (uint32_t i = 0; i < shm_bbo::venues; ++i)
+        uniform = uniform && q.bid.qty[i] == n && q.ask.qty[i] == n;
+    return uniform;
+}
+
+void expect_same_side(const shm_bbo::side& side, const order_book::tick_data& reference) {
+    EXPECT_DOUBLE_EQ(side.price, reference.price);
+    for (uint32_t i = 0; i < shm_bbo::venues; ++i)
+        EXPECT_DOUBLE_EQ(side.qty[i], reference.qty[i]) << "venue " << i;
+}
+
+}   // namespace
+
+
+TEST(ShmBbo, WritesOnlyChanges) {
+    std::string name = table_name("table");
+    auto writer = std::make_unique<shm_bbo::writer>();
+    ASSERT_TRUE(writer->open(name, 4));
+    EXPECT_FALSE(writer->fits(4));
+
+    shm_bbo::reader reader;
+    ASSERT_TRUE(reader.open(name));
+    EXPECT_EQ(reader.capacity(), 4u);
+    EXPECT_EQ(reader.find("BTCUSDT"), -1);
+
+    writer->name(2, "BTCUSDT");
+    ASSERT_TRUE(writer->update(2, uniform_quote(1)));
+    ASSERT_EQ(reader.find("BTCUSDT"), 2);
+    EXPECT_EQ(reader.find("BTCUSD"), -1);
+    shm_bbo::quote q;
+    uint64_t sequence;
+    ASSERT_TRUE(reader.read(2, q, sequence));
+    EXPECT_TRUE(is_uniform(q));
+    EXPECT_EQ(q.tick_id, 1);
+    EXPECT_FALSE(reader.read(0, q));
+
+    // the same prices and quantities from another batch: not written
+    shm_bbo::quote same = uniform_quote(1);
+    same.tick_id = 2;
+    EXPECT_FALSE(writer->update(2, same));
+    EXPECT_EQ(reader.sequence(2), sequence);
+    ASSERT_TRUE(writer->update(2, uniform_quote(3)));
+    EXPECT_EQ(reader.sequence(2), sequence + 2);
+    ASSERT_TRUE(reader.read(2, q));
+    EXPECT_EQ(q.tick_id, 3);
+
+    EXPECT_FALSE(reader.closed());
+    writer.reset();
+    EXPECT_TRUE(reader.closed());
+    ASSERT_TRUE(reader.read(2, q));     // the last quote stays
+    shm_bbo::reader gone;
+    EXPECT_FALSE(gone.open(name));
+}
+
+// A reader racing a writer that never stops: each quote read is one of the
+// quotes written, never parts of two.
+TEST(ShmBbo, ReadsAreNeverTorn) {
+    std::string name = table_name("torn");
+    shm_bbo::writer writer;
+    ASSERT_TRUE(writer.open(name, 1));
+    writer.name(0, "BTCUSDT");
+    writer.update(0, uniform_quote(1));
+
+    std::atomic<bool> stop{false};
+    std::thread writing([&] {
+        for (int n = 2; !stop.load(std::memory_order_relaxed); ++n)
+            writer.update(0, uniform_quote(n));
+    });
+
+    shm_bbo::reader reader;
+    ASSERT_TRUE(reader.open(name));
+    double last = 0;
+    int torn = 0;
+    auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+    while (std::chrono::steady_clock::now() < until) {
+        shm_bbo::quote q;
+        ASSERT_TRUE(reader.read(0, q));
+        torn += !is_uniform(q);
+        EXPECT_GE(q.bid.price, last);
+        last = q.bid.price;
+    }
+    stop = true;
+    writing.join();
+    EXPECT_EQ(torn, 0);
+    EXPECT_GT(last, 1);
+}
+
+// The server writes the best bid / ask of its consolidated books, with the
+// quantity of each exchange, as client1 computes them.
+TEST(ShmBbo, ServerQuotesTheConsolidatedBook) {
+    symbol_registry& symbols = test_symbols();
+    symbols.intern("ETHUSDT");
+    std::string name = table_name("server");
+    aggregator_server_config server_config;
+    server_config.shm_bbo_name = name;
+    server_config.shm_bbo_symbols = 16;
+    aggregator_server server(port, symbols, {}, 0, server_config);
+    shm_bbo::reader reader;
+    ASSERT_TRUE(reader.open(name));
+
+    // a server without queue threads applies the batches as they are published
+    std::mt19937 rng(50);
+    extended_book btc, eth;
+    int64_t tick_id = 0;
+    for (int i = 0; i < 200; ++i) {
+        auto ticks = make_batch(rng, 1 + i % 3, ++tick_id, 20);
+        btc.update_ticks(ticks);
+        server.process_tick(0, ticks);
+        auto other = make_batch(rng, 1 + i % 2, tick_id, 20);
+        other.set_symbol_id(1);
+        eth.update_ticks(other);
+        server.process_tick(1, other);
+
+        if (i % 50 != 49)
+            continue;
+        ASSERT_EQ(reader.find("BTCUSDT"), 0);
+        ASSERT_EQ(reader.find("ETHUSDT"), 1);
+        shm_bbo::quote q;
+        ASSERT_TRUE(reader.read(0, q));
+        expect_same_side(q.bid, btc.best_bid());
+        expect_same_side(q.ask, btc.best_ask());
+        EXPECT_LE(q.tick_id, tick_id);
+        ASSERT_TRUE(reader.read(1, q));
+        expect_same_side(q.bid, eth.best_bid());
+        expect_same_side(q.ask, eth.best_ask());
+    }
+}
@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include "stream_test_util.h"
+#include "../client/base_client.h"
+#include "../shm_ring.h"
+
+
+using namespace stream_test;
+
+namespace {
+
+const uint16_t port = 50182;
+
+std::string ring_name(const char* test) {
+    return "/agg_test_" + std::to_string(getpid()) + "_" + test;
+}
+
+bool write(shm_ring::writer& writer, const std::string& message) {
+    return writer.write(message.size(), [&] (char* data) { memcpy(data, message.data(), message.size()); });
+}
+
+// builds the book of BTCUSDT from what it reads
+class book_client : public base_client<book_client> {
+public:
+    explicit book_client(const std::string& connection_str) : base_client<book_client>(connection_str) {}
+
+    void process_ticks(const batched_tick_update& ticks) {
+        if (ticks.symbol_id() != 0)
+            ++other_symbols_;
+        book_.update_ticks(ticks);
+        last_tick_id_ = ticks.tick_id();
+        ++batches_;
+    }
+
+    void process_reset() {
+        book_ = extended_book();
+        ++resets_;
+    }
+
+    const extended_book& book() const { return book_; }
+    int64_t last_tick_id() const { return last_tick_id_; }
+    size_t batches() const { return batches_; }
+    size_t other_symbols() const { return other_symbols_; }
+    int resets() const { return resets_; }
+
+private:
+    extended_book book_;
+    int64_t last_tick_id_ = 0;
+    size_t batches_ = 0;
+    size_t other_symbols_ = 0;
+    int resets_ = 0;
+};
+
+symbol_registry& two_symbols() {
+    symbol_registry& symbols = test_symbols();
+    symbols.intern("ETHUSDT");
+    return symbols;
+}
+
+// BTCUSDT batches into reference, interleaved with ETHUSDT ones
+void publish_both(aggregator_server& server, extended_book& reference, std::mt19937& rng, int64_t& tick_id, int n) {
+    for (int i = 0; i < n; ++i) {
+        auto ticks = make_batch(rng, 1 + i % 2, ++tick_id, 20);
+        reference.update_ticks(ticks);
+        server.process_tick(0, ticks);
+        auto other = make_batch(rng, 1 + i % 2, tick_id, 20);
+        other.set_symbol_id(1);
+        server.process_tick(1, other);
+    }
+}
+
+void read_until(book_client& client, int64_t tick_id) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (client.last_tick_id() != tick_id && std::chrono::steady_clock::now() < deadline)
+        client.poll(std::chrono::system_clock::now() + std::chrono::milliseconds(10));
+    ASSERT_EQ(client.last_tick_id(), tick_id);
+}
+
+}   // namespace
+
+
+TEST(ShmRing, ReadsInOrderAndDetectsOverrun) {
+    std::string name = ring_name("ring");
+    auto writer = std::make_unique<shm_ring::writer>();
+    shm_ring::config config;
+    config.slots = 8;
+    config.slot_bytes = 256;
+    ASSERT_TRUE(writer->open(name, config));
+    EXPECT_EQ(writer->max_message(), 256u - 64);
+    EXPECT_FALSE(write(*writer, std::string(256, 'x')));
+
+    shm_ring::reader reader;
+    ASSERT_TRUE(reader.open(name));
+    std::string message;
+    uint64_t lost = 0;
+    EXPECT_EQ(reader.read(message, lost), shm_ring::read_result::none);
+    for (int i = 1; i <= 5; ++i)
+        ASSERT_TRUE(write(*writer, "message " + std::to_string(i)));
+    for (int i = 1; i <= 5; ++i) {
+        ASSERT_EQ(reader.read(message, lost), shm_ring::read_result::message);
+        EXPECT_EQ(message, "message " + std::to_string(i));
+    }
+
+    // 20 more: the first 12 of them are overwritten before being read
+    // (message 1 was too large, dropped)
+    for (int i = 6; i <= 25; ++i)
+        write(*writer, "message " + std::to_string(i));
+    ASSERT_EQ(reader.read(message, lost), shm_ring::read_result::overrun);
+    EXPECT_EQ(lost, 12u);
+    for (int i = 18; i <= 25; ++i) {
+        ASSERT_EQ(reader.read(message, lost), shm_ring::read_result::message);
+        EXPECT_EQ(message, "message " + std::to_string(i));
+    }
+    EXPECT_EQ(reader.read(message, lost), shm_ring::read_result::none);
+
+    // too large: its number is taken, the readers see it dropped
+    EXPECT_FALSE(write(*writer, std::string(256, 'x')));
+    ASSERT_TRUE(write(*writer, "message 26"));
+    EXPECT_EQ(writer->published(), 28u);
+    ASSERT_EQ(reader.read(message, lost), shm_ring::read_result::dropped);
+    EXPECT_EQ(lost, 1u);
+    EXPECT_EQ(reader.next(), 28u);
+    ASSERT_EQ(reader.read(message, lost), shm_ring::read_result::message);
+    EXPECT_EQ(message, "message 26");
+
+    writer.reset();
+    EXPECT_EQ(reader.read(message, lost), shm_ring::read_result::closed);
+    shm_ring::reader gone;
+    EXPECT_FALSE(gone.open(name));
+}
+
+// A client reading the ring instead of a stream: the snapshot over gRPC,
+// then the batches of its symbol only, to the same book as the publisher.
+TEST(ShmRing, ClientBuildsTheBookFromTheRing) {
+    std::string name = ring_name("client");
+    aggregator_server_config server_config;
+    server_config.shm_ring_name = name;
+    aggregator_server server(port, two_symbols(), {}, 1, server_config);
+    std::mt19937 rng(49);
+    extended_book reference;
+    int64_t tick_id = 0;
+    publish_both(server, reference, rng, tick_id, 50);
+
+    book_client client(absl::StrFormat("localhost:%d", port));
+    client.subscribe_shm({"BTCUSDT"}, name);
+    EXPECT_EQ(client.subscriptions(), 1u);
+    publish_both(server, reference, rng, tick_id, 50);
+    read_until(client, tick_id);
+    EXPECT_EQ(client.other_symbols(), 0u);
+    expect_same_levels(client.book(), reference);
+}
+
+// Lapped by the server, the client is told, drops its book and starts over
+// from a snapshot.
+TEST(ShmRing, ClientLappedStartsOver) {
+    std::string name = ring_name("lapped");
+    aggregator_server_config server_config;
+    server_config.shm_ring_name = name;
+    server_config.shm_ring_config.slots = 16;
+    aggregator_server server(port, two_symbols(), {}, 1, server_config);
+    book_client client(absl::StrFormat("localhost:%d", port));
+    client.subscribe_shm({"BTCUSDT"}, name);
+
+    std::mt19937 rng(50);
+    extended_book reference;
+    int64_t tick_id = 0;
+    publish_both(server, reference, rng, tick_id, 5);
+    read_until(client, tick_id);
+    EXPECT_EQ(client.gaps(), 0u);
+
+    // not read meanwhile
+    publish_both(server, reference, rng, tick_id, 100);
+    publish_both(server, reference, rng, tick_id, 2);
+    read_until(client, tick_id);
+    EXPECT_EQ(client.gaps(), 1u);
+    EXPECT_EQ(client.resets(), 1);
+    expect_same_levels(client.book(), reference);
+}
+
+// A batch too large for a slot leaves its number marked dropped: the client
+// is told, drops its book and starts over from a snapshot that has it.
+TEST(ShmRing, ClientStartsOverAfterADroppedBatch) {
+    std::string name = ring_name("dropped");
+    aggregator_server_config server_config;
+    server_config.shm_ring_name = name;
+    server_config.shm_ring_config.slot_bytes = 2048;
+    aggregator_server server(port, two_symbols(), {}, 1, server_config);
+    const shm_ring::config& config = server_config.shm_ring_config;
+    book_client client(absl::StrFormat("localhost:%d", port));
+    client.subscribe_shm({"BTCUSDT"}, name);
+
+    std::mt19937 rng(51);
+    extended_book reference;
+    int64_t tick_id = 0;
+    publish_both(server, reference, rng, tick_id, 5);
+    read_until(client, tick_id);
+    EXPECT_EQ(client.gaps(), 0u);
+
+    auto large = make_batch(rng, 1, ++tick_id, 200);
+    ASSERT_GT(large.ByteSizeLong(), config.slot_bytes);
+    reference.update_ticks(large);
+    server.process_tick(0, large);
+    publish_both(server, reference, rng, tick_id, 2);
+    read_until(client, tick_id);
+    EXPECT_EQ(client.gaps(), 1u);
+    EXPECT_EQ(client.resets(), 1);
+    expect_same_levels(client.book(), reference);
+}
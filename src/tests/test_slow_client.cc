@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+
+#include "stream_test_util.h"
+
+
+using namespace stream_test;
+
+namespace {
+
+const uint16_t port = 50161;
+
+}   // namespace
+
+
+TEST(SlowClient, DropOldest_BoundsDepth) {
+    client_queue_config config;
+    config.max_depth = 16;
+    config.policy = slow_client_policy::drop_oldest;
+    aggregator_server server(port, test_symbols(), config);
+    stream_client client(port);
+    wait_connected(server);
+
+    std::mt19937 rng(1);
+    extended_book reference;
+    int64_t tick_id = 0;
+    publish(server, reference, rng, tick_id, 2000);
+
+    ASSERT_EQ(server.clients().size(), 1u);
+    const client_queue_stats& stats = server.clients()[0]->stats();
+    EXPECT_LE(stats.max_depth, config.max_depth + 1);
+    EXPECT_GT(stats.dropped, 0u);
+    EXPECT_EQ(stats.queued, 2000u);
+
+    // every batch dropped is a number missing from the stream
+    extended_book book;
+    batched_tick_update last;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (last.sequence() != 2000 && std::chrono::steady_clock::now() < deadline) {
+        server.poll_non_block();
+        client.poll(book, last);
+    }
+    ASSERT_EQ(last.sequence(), 2000u);
+    EXPECT_EQ(missing_sequences(client.received()), stats.dropped);
+}
+
+TEST(SlowClient, Disconnect_FinishesStream) {
+    client_queue_config config;
+    config.max_depth = 16;
+    config.policy = slow_client_policy::disconnect;
+    aggregator_server server(port, test_symbols(), config);
+    stream_client client(port);
+    wait_connected(server);
+
+    std::mt19937 rng(2);
+    extended_book reference;
+    int64_t tick_id = 0;
+    publish(server, reference, rng, tick_id, 2000);
+    EXPECT_TRUE(server.clients().empty());
+
+    // the client drains what was written before the disconnect, then gets the status
+    extended_book book;
+    batched_tick_update last;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (client.poll(book, last) && std::chrono::steady_clock::now() < deadline)
+        server.poll_non_block();
+    EXPECT_EQ(client.status().error_code(), grpc::StatusCode::RESOURCE_EXHAUSTED);
+}
+
+TEST(SlowClient, Conflate_KeepsBookConsistent) {
+    client_queue_config config;
+    config.max_depth = 16;
+    config.policy = slow_client_policy::conflate;
+    aggregator_server server(port, test_symbols(), config);
+    stream_client client(port);
+    wait_connected(server);
+
+    std::mt19937 rng(3);
+    extended_book reference;
+    int64_t tick_id = 0;
+    publish(server, reference, rng, tick_id, 2000);
+
+    const client_queue_stats& stats = server.clients()[0]->stats();
+    EXPECT_LE(stats.max_depth, config.max_depth + 2);     // + 1 per exchange
+    EXPECT_GT(stats.conflated, 0u);
+    EXPECT_EQ(stats.dropped, 0u);
+
+    expect_same_book(server, client, reference, tick_id);
+    EXPECT_EQ(missing_sequences(client.received()), 0u);
+    // one update per level: no more than the 100 bid and 100 ask prices make_batch draws
+    EXPECT_LE(client.max_updates(), 200);
+    EXPECT_EQ(publish_sequence_regressions(client.received()), 0u);
+}
+
+TEST(SlowClient, ConflateLevels_SendsNetChanges) {
+    client_queue_config config;
+    config.max_depth = 16;
+    config.policy = slow_client_policy::disconnect;     // never reached, the levels are merged
+    aggregator_server server(port, test_symbols(), config);
+    stream_client client(port, true);
+    wait_connected(server);
+
+    std::mt19937 rng(4);
+    extended_book reference;
+    int64_t tick_id = 0;
+    publish(server, reference, rng, tick_id, 2000, 1000);
+
+    ASSERT_EQ(server.clients().size(), 1u);
+    const client_queue_stats& stats = server.clients()[0]->stats();
+    EXPECT_LE(stats.max_depth, 3u);     // the write in flight + one batch per exchange
+    EXPECT_GT(stats.conflated, 0u);
+
+    expect_same_book(server, client, reference, tick_id);
+    EXPECT_EQ(publish_sequence_regressions(client.received()), 0u);
+}
+
+// Two symbols on one stream, with the same prices: each batch is conflated
+// into a queued batch of its own symbol and exchange only.
+TEST(SlowClient, Conflate_KeepsSymbolsApart) {
+    for (bool levels : {false, true}) {
+        SCOPED_TRACE(levels ? "level conflation" : "conflate policy");
+        symbol_registry symbols;
+        symbols.intern("BTCUSDT");
+        symbols.intern("ETHUSDT");
+        client_queue_config config;
+        config.max_depth = 16;
+        config.policy = slow_client_policy::conflate;
+        aggregator_server server(port, symbols, config);
+        tick_request request;
+        request.add_symbols("BTCUSDT");
+        request.add_symbols("ETHUSDT");
+        request.set_conflate(levels);
+        stream_client client(port, request);
+        wait_connected(server);
+
+        std::mt19937 rng(6);
+        extended_book reference[2];
+        std::map<std::pair<uint32_t, uint32_t>, int64_t> last_tick_id;     // by (symbol_id, exchange)
+        int64_t tick_id = 0;
+        for (int i = 0; i < 2000; ++i) {
+            auto ticks = make_batch(rng, 1 + i / 2 % 2, ++tick_id, 200);
+            ticks.set_symbol_id(i % 2);
+            reference[i % 2].update_ticks(ticks);
+            last_tick_id[{ticks.symbol_id(), ticks.exchange()}] = tick_id;
+            server.process_tick(ticks.symbol_id(), ticks);
+            for (int j = 0; j < 10; ++j)
+                server.poll_non_block();
+        }
+        EXPECT_GT(server.clients()[0]->stats().conflated, 0u);
+
+        // conflated batches carry the tick_id of the last batch merged
+        extended_book book;
+        batched_tick_update last;
+        std::map<std::pair<uint32_t, uint32_t>, int64_t> seen;
+        size_t read = 0;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (seen != last_tick_id && std::chrono::steady_clock::now() < deadline) {
+            server.poll_non_block();
+            client.poll(book, last);
+            for (; read < client.received().size(); ++read)
+                seen[{client.received()[read].symbol_id(), client.received()[read].exchange()}] = client.received()[read].tick_id();
+        }
+        ASSERT_EQ(seen, last_tick_id);
+        ASSERT_EQ(client.books().size(), 2u);
+        expect_same_levels(client.books().at(0), reference[0]);
+        expect_same_levels(client.books().at(1), reference[1]);
+        EXPECT_EQ(publish_sequence_regressions(client.received()), 0u);
+    }
+}
+
+TEST(SlowClient, Coalesce_WritesQueuedBatchesAtOnce) {
+    client_queue_config config;
+    config.max_depth = 4096;
+    config.policy = slow_client_policy::disconnect;     // never reached
+    aggregator_server server(port, test_symbols(), config);
+    tick_request request;
+    request.set_symbol("BTCUSDT");
+    request.set_coalesce(true);
+    stream_client client(port, request);
+    wait_connected(server);
+
+    std::mt19937 rng(5);
+    extended_book reference;
+    int64_t tick_id = 0;
+    publish(server, reference, rng, tick_id, 2000);
+
+    expect_same_book(server, client, reference, tick_id);
+    // the last write is counted once the server sees it complete
+    const client_queue_stats& stats = server.clients()[0]->stats();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (stats.written < 2000 && std::chrono::steady_clock::now() < deadline)
+        server.poll_non_block();
+    EXPECT_EQ(stats.written, 2000u);
+    EXPECT_LT(stats.writes, stats.written);
+    EXPECT_LT(client.reads(), client.received().size());
+    EXPECT_EQ(client.received().size(), 2000u);
+    EXPECT_EQ(missing_sequences(client.received()), 0u);
+    EXPECT_EQ(client.received().back().sequence(), 2000u);
+}
+
+// the sequence fields and the framing of each batch count in max_coalesced_bytes
+TEST(SlowClient, Coalesce_WritesAtMostMaxBytes) {
+    std::mt19937 rng(7);
+    batched_tick_update ticks = make_batch(rng, 1, 1, 200);
+    grpc::ByteBuffer payload;
+    serialize_batch(ticks, agg_proto::encoding_updates, payload);
+
+    client_queue_config config;
+    config.max_coalesced_bytes = 4 * payload.Length();
+    client_queue queue(config);
+    queue.set_coalesce(true);
+    for (uint64_t published = 1; published <= 16; ++published)
+        queue.push(ticks, payload, published);
+    while (!queue.empty()) {
+        const grpc::ByteBuffer& written = queue.begin_write();
+        EXPECT_LE(written.Length(), config.max_coalesced_bytes);
+        queue.end_write();
+    }
+    EXPECT_EQ(queue.stats().written, 16u);
+    EXPECT_GT(queue.stats().writes, 4u);
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include "stream_test_util.h"
+
+
+using namespace stream_test;
+using agg_proto::tick_snapshot;
+
+namespace {
+
+const uint16_t port = 50162;
+
+}   // namespace
+
+
+TEST(Snapshot, SnapshotOnConnect_ThenLiveStream) {
+    aggregator_server server(port, test_symbols());
+
+    // the book is built before anyone subscribes
+    std::mt19937 rng(5);
+    extended_book reference;
+    int64_t tick_id = 0;
+    publish(server, reference, rng, tick_id, 500);
+
+    stream_client client(port);
+    wait_connected(server);
+    publish(server, reference, rng, tick_id, 500);
+
+    expect_same_book(server, client, reference, tick_id);
+
+    const auto& received = client.received();
+    ASSERT_GE(received.size(), 2u);
+    EXPECT_EQ(received[0].exchange(), 1u);
+    EXPECT_EQ(received[0].flag(), (uint64_t) updata_flag_t::snapshot);
+    EXPECT_EQ(received[1].exchange(), 2u);
+    EXPECT_EQ(received[1].flag(), (uint64_t) updata_flag_t::snapshot);
+    for (size_t i = 2; i < received.size(); ++i)
+        EXPECT_EQ(received[i].flag(), 0u);
+}
+
+TEST(Snapshot, SnapshotRequest) {
+    aggregator_server server(port, test_symbols());
+
+    std::mt19937 rng(6);
+    extended_book reference;
+    int64_t tick_id = 0;
+    publish(server, reference, rng, tick_id, 500);
+
+    auto stub = agg_service::NewStub(grpc::CreateChannel(absl::StrFormat("localhost:%d", port), grpc::InsecureChannelCredentials()));
+    auto request_snapshot = [&] (const std::string& symbol, tick_snapshot& reply) {
+        grpc::ClientContext ctx;
+        grpc::CompletionQueue cq;
+        tick_request request;
+        request.set_symbol(symbol);
+        grpc::Status status;
+        auto call = stub->AsyncTickSnapshotRequest(&ctx, request, &cq);
+        call->Finish(&reply, &status, &cq);
+
+        void* tag;
+        bool ok;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::chrono::steady_clock::now() < deadline) {
+            server.poll_non_block();
+            if (cq.AsyncNext(&tag, &ok, std::chrono::system_clock::now() + std::chrono::milliseconds(1)) == grpc::CompletionQueue::GOT_EVENT)
+                break;
+        }
+        return status;
+    };
+
+    tick_snapshot snapshot;
+    ASSERT_TRUE(request_snapshot("BTCUSDT", snapshot).ok());
+    ASSERT_EQ(snapshot.books_size(), 2);
+    extended_book book;
+    for (const auto& ticks : snapshot.books()) {
+        EXPECT_EQ(ticks.symbol_id(), 0u);    // BTCUSDT
+        EXPECT_EQ(ticks.flag(), (uint64_t) updata_flag_t::snapshot);
+        book.update_ticks(ticks);
+    }
+    expect_same_levels(book, reference);
+
+    tick_snapshot unknown;
+    EXPECT_EQ(request_snapshot("ETHUSDT", unknown).error_code(), grpc::StatusCode::NOT_FOUND);
+}
+
+TEST(Snapshot, ListSymbols) {
+    symbol_registry& symbols = test_symbols();
+    aggregator_server server(port, symbols);
+
+    std::mt19937 rng(7);
+    extended_book reference;
+    int64_t tick_id = 0;
+    publish(server, reference, rng, tick_id, 10);
+
+    auto stub = agg_service::NewStub(grpc::CreateChannel(absl::StrFormat("localhost:%d", port), grpc::InsecureChannelCredentials()));
+    auto list = [&] (const std::vector<std::string>& names, agg_proto::symbol_list& reply) {
+        grpc::ClientContext ctx;
+        grpc::CompletionQueue cq;
+        agg_proto::symbol_list_request request;
+        for (const auto& name : names)
+            request.add_symbols(name);
+        grpc::Status status;
+        auto call = stub->AsyncListSymbols(&ctx, request, &cq);
+        call->Finish(&reply, &status, &cq);
+
+        void* tag;
+        bool ok;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::chrono::steady_clock::now() < deadline) {
+            server.poll_non_block();
+            if (cq.AsyncNext(&tag, &ok, std::chrono::system_clock::now() + std::chrono::milliseconds(1)) == grpc::CompletionQueue::GOT_EVENT)
+                break;
+        }
+        return status;
+    };
+
+    // the sizes from the decimals of the batches
+    agg_proto::symbol_list all;
+    ASSERT_TRUE(list({}, all).ok());
+    ASSERT_GE(all.symbols_size(), 1);
+    EXPECT_EQ(all.symbols(0).id(), 0u);
+    EXPECT_EQ(all.symbols(0).name(), "BTCUSDT");
+    EXPECT_GT(all.symbols(0).tick_size(), 0);
+    EXPECT_GT(all.symbols(0).lot_size(), 0);
+
+    // configured ones first; a name that is not a symbol is left out, and not interned
+    symbols.set_sizes(0, {0.01, 0.00001});
+    size_t known = symbols.size();
+    agg_proto::symbol_list some;
+    ASSERT_TRUE(list({"BTCUSDT", "NOSUCHSYMBOL"}, some).ok());
+    ASSERT_EQ(some.symbols_size(), 1);
+    EXPECT_EQ(some.symbols(0).name(), "BTCUSDT");
+    EXPECT_EQ(some.symbols(0).tick_size(), 0.01);
+    EXPECT_EQ(some.symbols(0).lot_size(), 0.00001);
+    EXPECT_EQ(symbols.size(), known);
+
+    // no sizes before the first batch
+    symbol_id_t sol = symbols.intern("SOLUSDT");
+    some.Clear();
+    ASSERT_TRUE(list({"SOLUSDT"}, some).ok());
+    ASSERT_EQ(some.symbols_size(), 1);
+    EXPECT_EQ(some.symbols(0).id(), sol);
+    EXPECT_EQ(some.symbols(0).tick_size(), 0);
+}
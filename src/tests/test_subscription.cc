@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include "stream_test_util.h"
+
+
+using namespace stream_test;
+
+namespace {
+
+const uint16_t port = 50163;
+
+tick_request make_request(std::vector<std::string> symbols, std::vector<uint32_t> exchanges = {}) {
+    tick_request request;
+    for (const auto& symbol : symbols)
+        request.add_symbols(symbol);
+    for (uint32_t exchange : exchanges)
+        request.add_exchanges(exchange);
+    return request;
+}
+
+}   // namespace
+
+
+TEST(Subscription, RoutesBySymbolAndExchange) {
+    symbol_registry& symbols = test_symbols();
+    symbol_id_t btc = symbols.intern("BTCUSDT");
+    symbol_id_t eth = symbols.intern("ETHUSDT");
+    aggregator_server server(port, symbols);
+
+    tick_request legacy;
+    legacy.set_symbol("BTCUSDT");
+    tick_request by_id;
+    by_id.add_symbol_ids(eth);
+    std::vector<std::unique_ptr<stream_client>> clients;
+    clients.push_back(std::make_unique<stream_client>(port, legacy));
+    clients.push_back(std::make_unique<stream_client>(port, by_id));
+    clients.push_back(std::make_unique<stream_client>(port, make_request({"BTCUSDT", "ETHUSDT"})));
+    clients.push_back(std::make_unique<stream_client>(port, make_request({"BTCUSDT"}, {2})));
+    clients.push_back(std::make_unique<stream_client>(port, make_request({})));
+    wait_connected(server, clients.size());
+
+    // BTCUSDT / ETHUSDT on exchange 1 / 2, 25 batches each
+    std::mt19937 rng(7);
+    for (int i = 0; i < 100; ++i) {
+        bool is_btc = i % 2 == 0;
+        auto ticks = make_batch(rng, 1 + (i / 2) % 2, i + 1, 10);
+        ticks.set_symbol_id(is_btc ? btc : eth);
+        server.process_tick(is_btc ? btc : eth, ticks);
+        server.poll_non_block();
+    }
+
+    std::vector<size_t> expected = {50, 50, 100, 25, 100};
+    std::vector<extended_book> books(clients.size());
+    batched_tick_update last;
+    auto done = [&] {
+        for (size_t i = 0; i < clients.size(); ++i)
+            if (clients[i]->received().size() < expected[i]) return false;
+        return true;
+    };
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!done() && std::chrono::steady_clock::now() < deadline) {
+        server.poll_non_block();
+        for (size_t i = 0; i < clients.size(); ++i)
+            clients[i]->poll(books[i], last);
+    }
+    for (size_t i = 0; i < clients.size(); ++i)
+        EXPECT_EQ(clients[i]->received().size(), expected[i]) << "client " << i;
+
+    for (const auto& ticks : clients[0]->received())
+        EXPECT_EQ(ticks.symbol_id(), btc);
+    for (const auto& ticks : clients[1]->received())
+        EXPECT_EQ(ticks.symbol_id(), eth);
+    for (const auto& ticks : clients[3]->received()) {
+        EXPECT_EQ(ticks.symbol_id(), btc);
+        EXPECT_EQ(ticks.exchange(), 2u);
+    }
+}
+
+TEST(Subscription, SnapshotOfSubscribedSymbolsOnly) {
+    symbol_registry& symbols = test_symbols();
+    symbol_id_t btc = symbols.intern("BTCUSDT");
+    symbol_id_t eth = symbols.intern("ETHUSDT");
+    aggregator_server server(port, symbols);
+
+    std::mt19937 rng(8);
+    for (int i = 0; i < 20; ++i) {
+        auto ticks = make_batch(rng, 1 + i % 2, i + 1, 10);
+        ticks.set_symbol_id(i < 10 ? btc : eth);
+        server.process_tick(i < 10 ? btc : eth, ticks);
+    }
+
+    stream_client client(port, make_request({"ETHUSDT"}, {1}));
+    wait_connected(server);
+
+    extended_book book;
+    batched_tick_update last;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (client.received().empty() && std::chrono::steady_clock::now() < deadline) {
+        server.poll_non_block();
+        client.poll(book, last);
+    }
+    ASSERT_EQ(client.received().size(), 1u);
+    EXPECT_EQ(client.received()[0].symbol_id(), eth);
+    EXPECT_EQ(client.received()[0].exchange(), 1u);
+    EXPECT_EQ(client.received()[0].flag(), (uint64_t) updata_flag_t::snapshot);
+}
+
+// names no link maps are not interned: the stream is NOT_FOUND
+TEST(Subscription, UnknownSymbolIsNotFound) {
+    symbol_registry& symbols = test_symbols();
+    aggregator_server server(port, symbols);
+    size_t known = symbols.size();
+
+    stream_client client(port, make_request({"BTCUSDT", "NOSUCHSYMBOL"}));
+    extended_book book;
+    batched_tick_update last;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (client.poll(book, last) && std::chrono::steady_clock::now() < deadline)
+        server.poll_non_block();
+    EXPECT_EQ(client.status().error_code(), grpc::StatusCode::NOT_FOUND);
+    EXPECT_TRUE(server.clients().empty());
+    EXPECT_EQ(symbols.size(), known);
+}
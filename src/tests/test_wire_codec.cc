@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+
+#include "stream_test_util.h"
+#include "../wire_codec.h"
+
+
+using namespace stream_test;
+
+namespace {
+
+const uint16_t port = 50169;
+
+batched_tick_update decimal_batch() {
+    batched_tick_update ticks;
+    ticks.set_symbol_id(0);
+    ticks.set_exchange(2);
+    ticks.set_tick_id(1700000000123);
+    ticks.set_flag((uint64_t) updata_flag_t::snapshot);
+    const double levels[][3] = {{1, 100000.12, 0.00123}, {2, 100000.5, 1.5}, {1, 99999.99, 0}, {2, 100001, 12.25}};
+    for (const auto& level : levels) {
+        auto& tick = *ticks.add_updates();
+        tick.set_side((uint32_t) level[0]);
+        tick.set_price(level[1]);
+        tick.set_quantity(level[2]);
+        tick.set_tick_id(ticks.tick_id());
+    }
+    return ticks;
+}
+
+}   // namespace
+
+
+TEST(WireCodec, RoundTripIsExact) {
+    batched_tick_update ticks = decimal_batch();
+    wire_codec::scale scale;
+    wire_codec::fit(ticks, scale);
+    EXPECT_EQ(scale.price, 2u);
+    EXPECT_EQ(scale.quantity, 5u);
+
+    batched_tick_update encoded, decoded;
+    wire_codec::encode(ticks, scale, encoded);
+    EXPECT_EQ(encoded.updates_size(), 0);
+    EXPECT_EQ(encoded.levels().prices(0), 10000012);
+    EXPECT_LT(encoded.ByteSizeLong(), ticks.ByteSizeLong() / 2);
+
+    wire_codec::decode(encoded, decoded);
+    EXPECT_EQ(decoded.SerializeAsString(), ticks.SerializeAsString());
+}
+
+TEST(WireCodec, ScaleOnlyGrows) {
+    batched_tick_update ticks = decimal_batch();
+    wire_codec::scale scale{4, 8};
+    wire_codec::fit(ticks, scale);
+    EXPECT_EQ(scale.price, 4u);
+    EXPECT_EQ(scale.quantity, 8u);
+
+    // still exact with more digits than needed
+    batched_tick_update encoded, decoded;
+    wire_codec::encode(ticks, scale, encoded);
+    wire_codec::decode(encoded, decoded);
+    EXPECT_EQ(decoded.SerializeAsString(), ticks.SerializeAsString());
+}
+
+TEST(WireCodec, PriceDeltasPerSide) {
+    batched_tick_update ticks = decimal_batch();
+    wire_codec::scale scale;
+    wire_codec::fit(ticks, scale);
+
+    batched_tick_update encoded, decoded;
+    wire_codec::encode(ticks, scale, encoded, true);
+    // bid, ask, bid, ask: each from the previous level of its side
+    const auto& prices = encoded.levels().prices();
+    EXPECT_EQ(prices[0], 10000012);
+    EXPECT_EQ(prices[1], 10000050);
+    EXPECT_EQ(prices[2], -13);
+    EXPECT_EQ(prices[3], 50);
+    wire_codec::decode(encoded, decoded);
+    EXPECT_EQ(decoded.SerializeAsString(), ticks.SerializeAsString());
+}
+
+TEST(WireCodec, MergedBatchKeepsExchanges) {
+    batched_tick_update ticks = decimal_batch();
+    ticks.set_exchange((uint32_t) exchange_t::undefined);
+    for (int i = 0; i < ticks.updates_size(); ++i)
+        ticks.mutable_updates(i)->set_exchange(1 + i % 3);
+    wire_codec::scale scale;
+    wire_codec::fit(ticks, scale);
+
+    batched_tick_update encoded, decoded;
+    wire_codec::encode(ticks, scale, encoded, true);
+    EXPECT_EQ(encoded.levels().exchanges_size(), ticks.updates_size());
+    wire_codec::decode(encoded, decoded);
+    EXPECT_EQ(decoded.SerializeAsString(), ticks.SerializeAsString());
+}
+
+// A quantity with 9 decimals takes the symbol to 10^9: a large one no longer
+// fits a mantissa, the batch goes as updates.
+TEST(WireCodec, OutOfRangeGoesAsUpdates) {
+    batched_tick_update ticks = decimal_batch();
+    ticks.mutable_updates(0)->set_quantity(0.000000001);
+    ticks.mutable_updates(1)->set_quantity(12e9);
+    wire_codec::scale scale;
+    wire_codec::fit(ticks, scale);
+    EXPECT_EQ(scale.quantity, wire_codec::max_scale);
+
+    batched_tick_update encoded;
+    EXPECT_FALSE(wire_codec::encode(ticks, scale, encoded));
+    ticks.mutable_updates(1)->set_quantity(std::nan(""));
+    EXPECT_FALSE(wire_codec::encode(ticks, scale, encoded));
+    ticks.mutable_updates(1)->set_quantity(12e9);
+
+    for (auto encoding : {agg_proto::encoding_compact, agg_proto::encoding_delta}) {
+        grpc::ByteBuffer payload;
+        serialize_batch(ticks, encoding, scale, payload);
+        batched_tick_update sent;
+        ASSERT_TRUE(grpc::SerializationTraits<batched_tick_update>::Deserialize(&payload, &sent).ok());
+        EXPECT_FALSE(sent.has_levels());
+        EXPECT_EQ(sent.SerializeAsString(), ticks.SerializeAsString());
+    }
+
+    // up to the bound it is still exact
+    ticks.mutable_updates(1)->set_quantity(4e9);
+    ASSERT_TRUE(wire_codec::encode(ticks, scale, encoded, true));
+    batched_tick_update decoded;
+    wire_codec::decode(encoded, decoded);
+    EXPECT_EQ(decoded.SerializeAsString(), ticks.SerializeAsString());
+}
+
+// the levels only tell bids from asks: a batch with another side goes as is
+TEST(WireCodec, OtherSidesGoAsUpdates) {
+    batched_tick_update ticks = decimal_batch();
+    ticks.mutable_updates(2)->set_side((uint32_t) side_t::undefined);
+    wire_codec::scale scale;
+    wire_codec::fit(ticks, scale);
+
+    batched_tick_update encoded;
+    EXPECT_FALSE(wire_codec::encode(ticks, scale, encoded));
+    ticks.mutable_updates(2)->set_side(7);
+    EXPECT_FALSE(wire_codec::encode(ticks, scale, encoded));
+
+    grpc::ByteBuffer payload;
+    serialize_batch(ticks, agg_proto::encoding_delta, scale, payload);
+    batched_tick_update sent;
+    ASSERT_TRUE(grpc::SerializationTraits<batched_tick_update>::Deserialize(&payload, &sent).ok());
+    EXPECT_FALSE(sent.has_levels());
+    EXPECT_EQ(sent.updates(2).side(), 7u);
+}
+
+// a batch merged from several: the levels share the latest tick_id
+TEST(WireCodec, OneTimestampPerBatch) {
+    batched_tick_update ticks = decimal_batch();
+    for (int i = 0; i < ticks.updates_size(); ++i)
+        ticks.mutable_updates(i)->set_tick_id(ticks.tick_id() - 3 + (i + 2) % 4);
+    wire_codec::scale scale;
+    wire_codec::fit(ticks, scale);
+
+    batched_tick_update encoded, decoded;
+    wire_codec::encode(ticks, scale, encoded);
+    EXPECT_EQ(encoded.levels().timestamp(), ticks.tick_id());
+    wire_codec::decode(encoded, decoded);
+    ASSERT_EQ(decoded.updates_size(), ticks.updates_size());
+    for (const auto& tick : decoded.updates())
+        EXPECT_EQ(tick.tick_id(), ticks.tick_id());
+}
+
+TEST(WireCodec, CompactStreamMatchesReference) {
+    client_queue_config config;
+    config.max_depth = 16;
+    aggregator_server server(port, test_symbols(), config);
+    tick_request request;
+    request.set_symbol("BTCUSDT");
+    request.set_encoding(agg_proto::encoding_compact);
+    stream_client compact(port, request);
+    // level conflation re-encodes what it merges
+    request.set_conflate(true);
+    request.set_encoding(agg_proto::encoding_delta);
+    stream_client conflated(port, request);
+    wait_connected(server, 2);
+
+    std::mt19937 rng(43);
+    extended_book reference;
+    int64_t tick_id = 0;
+    for (int i = 0; i < 500; ++i) {
+        auto ticks = make_batch(rng, 1 + i % 2, ++tick_id, 200);
+        // quantities on a lot, as the venues send them
+        for (auto& tick : *ticks.mutable_updates())
+            tick.set_quantity(std::round(tick.quantity() * 1e5) / 1e5);
+        reference.update_ticks(ticks);
+        server.process_tick(0, ticks);
+        for (int j = 0; j < 10; ++j)
+            server.poll_non_block();
+    }
+    EXPECT_GT(server.clients()[0]->stats().conflated + server.clients()[1]->stats().conflated, 0u);
+
+    expect_same_book(server, compact, reference, tick_id);
+    expect_same_book(server, conflated, reference, tick_id);
+}
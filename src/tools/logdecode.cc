@@ -0,0 +1,31 @@
+// Renders a binary log written by binlog::writer as text.
+//
+//   logdecode server.binlog > server.binlog.txt
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+#include "../binlog_decoder.h"
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        std::cerr << "usage: logdecode <file.binlog>" << std::endl;
+        return 1;
+    }
+
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::string error;
+    if (!binlog::decode(data, std::cout, error)) {
+        std::cerr << argv[1] << ": " << error << std::endl;
+        return 1;
+    }
+    return 0;
+}
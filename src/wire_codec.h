@@ -0,0 +1,171 @@
+#ifndef _WIRE_CODEC_H_
+#define _WIRE_CODEC_H_
+
+#include <stdint.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <string>
+
+#include "common.h"
+#include "protos/aggregator.pb.h"
+
+
+// The compact levels of batched_tick_update (tick_request.encoding
+// encoding_compact), shared by the server, which encodes, and the clients,
+// which decode back to updates.
+//
+// Prices and quantities are decimal mantissas: the server keeps the decimal
+// digits each symbol needs (scale), growing them with fit() as batches come,
+// so every level is exact. Past max_scale digits they are rounded. A level
+// whose mantissa would not fit in 62 bits (a large quantity of a symbol with
+// many decimals), or of a side other than bid or ask, is not encoded: the
+// batch goes as updates instead.
+//
+// encoding_delta writes each price as the difference, in ticks, with the
+// previous level of its side: the levels of an update cluster around the
+// touch, so most of them fit in one or two varint bytes.
+//
+// The tick_id of the levels is written once, as the batch timestamp: a batch
+// merged from several (batch_window, conflation) gives all its levels the
+// latest.
+namespace wire_codec {
+
+using agg_proto::batched_tick_update;
+using agg_proto::compact_levels;
+using agg_proto::tick_update;
+
+constexpr uint32_t max_scale = 9;
+// 2^62: the difference of two mantissas (price_deltas) still fits an int64_t
+constexpr double max_mantissa = 4611686018427387904.0;
+
+struct scale {
+    uint32_t price = 0;
+    uint32_t quantity = 0;
+};
+
+inline double power_of_ten(uint32_t n) {
+    static const double powers[max_scale + 1] = {1, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+    return powers[n];
+}
+
+// the decimal digits of value, at least digits
+inline uint32_t decimals(double value, uint32_t digits) {
+    for (; digits < max_scale; ++digits) {
+        double m = value * power_of_ten(digits);
+        // what the product lost in rounding, not a digit left
+        if (std::fabs(m - std::nearbyint(m)) <= std::fabs(m) * 4 * DBL_EPSILON)
+            return digits;
+    }
+    return max_scale;
+}
+
+// grows s until every level of ticks is exact
+inline void fit(const batched_tick_update& ticks, scale& s) {
+    for (const auto& tick : ticks.updates()) {
+        s.price = decimals(tick.price(), s.price);
+        s.quantity = decimals(tick.quantity(), s.quantity);
+    }
+}
+
+// whether value * factor rounds to a mantissa, false for NaN too
+inline bool fits(double value, double factor) {
+    return std::fabs(value * factor) < max_mantissa;
+}
+
+// ticks with its updates written as levels, out is overwritten. False if a
+// level does not fit at scale s or has no side the levels can tell, out is
+// not a batch to send then. The
+// consolidated levels of depth streams (venue_quantity) are not encoded.
+inline bool encode(const batched_tick_update& ticks, const scale& s, batched_tick_update& out,
+    bool price_deltas = false) {
+    out.Clear();
+    out.set_symbol(ticks.symbol());
+    out.set_symbol_id(ticks.symbol_id());
+    out.set_exchange(ticks.exchange());
+    out.set_tick_id(ticks.tick_id());
+    out.set_flag(ticks.flag());
+    out.set_sequence(ticks.sequence());
+    out.set_publish_sequence(ticks.publish_sequence());
+    out.set_publish_epoch(ticks.publish_epoch());
+
+    compact_levels& levels = *out.mutable_levels();
+    int n = ticks.updates_size();
+    double price_factor = power_of_ten(s.price), quantity_factor = power_of_ten(s.quantity);
+    levels.set_price_scale(s.price);
+    levels.set_quantity_scale(s.quantity);
+    levels.set_price_deltas(price_deltas);
+    int64_t timestamp = n > 0 ? ticks.updates(0).tick_id() : ticks.tick_id();
+    int64_t previous[2] = {};   // bid, ask
+    levels.mutable_prices()->Reserve(n);
+    levels.mutable_quantities()->Reserve(n);
+    std::string& asks = *levels.mutable_asks();
+    asks.assign((n + 7) / 8, '\0');
+    for (int i = 0; i < n; ++i) {
+        const tick_update& tick = ticks.updates(i);
+        if (!fits(tick.price(), price_factor) || !fits(tick.quantity(), quantity_factor))
+            return false;
+        if (tick.side() != (uint32_t) side_t::bid && tick.side() != (uint32_t) side_t::ask)
+            return false;
+        bool ask = tick.side() == (uint32_t) side_t::ask;
+        int64_t price = std::llround(tick.price() * price_factor);
+        levels.add_prices(price_deltas ? price - previous[ask] : price);
+        previous[ask] = price;
+        levels.add_quantities(std::llround(tick.quantity() * quantity_factor));
+        if (ask)
+            asks[i / 8] |= (char) (1 << (i % 8));
+        timestamp = std::max(timestamp, tick.tick_id());
+        if (tick.exchange() != (uint32_t) exchange_t::undefined && levels.exchanges_size() == 0) {
+            // a merged batch, from its first level carrying an exchange on
+            levels.mutable_exchanges()->Reserve(n);
+            for (int j = 0; j < i; ++j)
+                levels.add_exchanges(ticks.updates(j).exchange());
+        }
+        if (levels.exchanges_size() > 0)
+            levels.add_exchanges(tick.exchange());
+    }
+    if (asks.find_first_not_of('\0') == std::string::npos)
+        asks.clear();
+    levels.set_timestamp(timestamp);
+    return true;
+}
+
+// the same batch with its levels back as updates, out is overwritten
+inline void decode(const batched_tick_update& ticks, batched_tick_update& out) {
+    out.Clear();
+    out.set_symbol(ticks.symbol());
+    out.set_symbol_id(ticks.symbol_id());
+    out.set_exchange(ticks.exchange());
+    out.set_tick_id(ticks.tick_id());
+    out.set_flag(ticks.flag());
+    out.set_sequence(ticks.sequence());
+    out.set_publish_sequence(ticks.publish_sequence());
+    out.set_publish_epoch(ticks.publish_epoch());
+
+    const compact_levels& levels = ticks.levels();
+    int n = levels.prices_size();
+    // divided rather than multiplied by the inverse: the nearest double of the decimal, as parsed from the venue
+    double price_factor = power_of_ten(std::min(levels.price_scale(), max_scale));
+    double quantity_factor = power_of_ten(std::min(levels.quantity_scale(), max_scale));
+    const std::string& asks = levels.asks();
+    bool merged = levels.exchanges_size() == n;
+    int64_t previous[2] = {};   // bid, ask
+    out.mutable_updates()->Reserve(n);
+    for (int i = 0; i < n && i < levels.quantities_size(); ++i) {
+        tick_update& tick = *out.add_updates();
+        bool ask = (size_t) i / 8 < asks.size() && (asks[i / 8] >> (i % 8)) & 1;
+        tick.set_side((uint32_t) (ask ? side_t::ask : side_t::bid));
+        int64_t price = levels.price_deltas() ? previous[ask] + levels.prices(i) : levels.prices(i);
+        previous[ask] = price;
+        tick.set_price(price / price_factor);
+        tick.set_quantity(levels.quantities(i) / quantity_factor);
+        tick.set_tick_id(levels.timestamp());
+        if (merged)
+            tick.set_exchange(levels.exchanges(i));
+    }
+}
+
+}   // namespace wire_codec
+
+
+#endif  // _WIRE_CODEC_H_